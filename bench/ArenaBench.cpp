@@ -0,0 +1,106 @@
+//============================================================================
+// Name        : ArenaBench.cpp
+// Description : Measures how the multi-snake Arena tick scales with threads.
+//============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "Arena.h"
+
+/**
+ * Print the usage info for this benchmark.
+ */
+void print_usage() {
+	std::cout << "Usage: ArenaBench [ snakes board_size ticks max_threads ]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Defaults to 2000 snakes on a 1000x1000 board for 500 ticks, with 1 up to the"
+	          << std::endl;
+	std::cout << "number of hardware threads." << std::endl;
+}
+
+/**
+ * Run the benchmark: time the same seeded Arena at 1, 2, 4, ... threads
+ * and check that every thread count reaches the same final state.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero on success, one if the runs diverged.
+ */
+int main(int argc, char** argv) {
+	int snakes = 2000;
+	int board_size = 1000;
+	int ticks = 500;
+	int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	if (argc > 1 && std::string(argv[1]).rfind("-h", 0) == 0) {
+		print_usage();
+		return 0;
+	}
+	if (argc > 1) {
+		snakes = atoi(argv[1]);
+	}
+	if (argc > 2) {
+		board_size = atoi(argv[2]);
+	}
+	if (argc > 3) {
+		ticks = atoi(argv[3]);
+	}
+	if (argc > 4) {
+		max_threads = atoi(argv[4]);
+	}
+	if (snakes < 1 || board_size < 1 || ticks < 1 || max_threads < 1
+	        || (long) board_size * board_size < 4L * snakes) {
+		print_usage();
+		return 1;
+	}
+
+	std::cout << snakes << " snakes, " << board_size << "x" << board_size << " board, " << ticks
+	          << " ticks" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(14) << "ticks/sec" << std::setw(10)
+	          << "speedup" << std::setw(10) << "deaths" << std::setw(10) << "eaten"
+	          << std::setw(10) << "length" << std::endl;
+
+	double base_rate = 0;
+	long base_length = -1;
+	long base_deaths = -1;
+	bool diverged = false;
+	std::vector<int> thread_counts;
+	for (int threads = 1; threads < max_threads; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(max_threads);
+
+	for (int threads : thread_counts) {
+		Arena arena(board_size, board_size, snakes, snakes / 2 + 1, threads, 42);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int t = 0; t < ticks; t++) {
+			arena.tick();
+		}
+		auto end = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(end - start).count();
+		double rate = ticks / seconds;
+
+		if (threads == 1) {
+			base_rate = rate;
+			base_length = arena.total_length();
+			base_deaths = arena.deaths;
+		} else if (arena.total_length() != base_length || arena.deaths != base_deaths) {
+			diverged = true;
+		}
+		std::cout << std::setw(8) << threads << std::setw(14) << std::fixed
+		          << std::setprecision(1) << rate << std::setw(9) << std::setprecision(2)
+		          << rate / base_rate << "x" << std::setw(10) << arena.deaths << std::setw(10)
+		          << arena.treasures_eaten << std::setw(10) << arena.total_length() << std::endl;
+	}
+	if (diverged) {
+		std::cout << "Final states differ between thread counts." << std::endl;
+		return 1;
+	}
+	return 0;
+}
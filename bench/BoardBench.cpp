@@ -0,0 +1,121 @@
+//============================================================================
+// Name        : BoardBench.cpp
+// Description : Has a simple bot play the Game on small boards, as in a
+//               bot tournament, and reports the moves made per second.
+//============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "Game.h"
+
+/**
+ * Turn the Snake towards the treasure, or away from whatever it is
+ * about to run into.
+ * @param game The Game to steer.
+ */
+void steer(Game* game) {
+	Snake* snake = game->snake;
+	Point head = snake->head();
+	Direction options[7];
+	int count = 0;
+	if (game->treasure.x != head.x) {
+		options[count++] = game->treasure.x < head.x ? Direction::LEFT : Direction::RIGHT;
+	}
+	if (game->treasure.y != head.y) {
+		options[count++] = game->treasure.y < head.y ? Direction::UP : Direction::DOWN;
+	}
+	options[count++] = snake->direction;
+	options[count++] = Direction::UP;
+	options[count++] = Direction::DOWN;
+	options[count++] = Direction::LEFT;
+	options[count++] = Direction::RIGHT;
+	for (int o = 0; o < count; o++) {
+		Direction d = options[o];
+		int x = head.x + DIRECTION_DX[static_cast<int>(d)];
+		int y = head.y + DIRECTION_DY[static_cast<int>(d)];
+		if (!game->is_blocked(x, y)) {
+			snake->direction = d;
+			return;
+		}
+	}
+}
+
+/**
+ * Results of playing a number of games on one size of board.
+ */
+struct BenchResult {
+	double steps_per_sec;
+	long games;
+	long total_score;
+};
+
+/**
+ * Play games back to back until steps moves have been made.
+ * @param width The width of the board.
+ * @param height The height of the board.
+ * @param steps The number of moves to make.
+ * @return The throughput and the scores reached.
+ */
+BenchResult play(int width, int height, long steps) {
+	BenchResult result = { 0, 0, 0 };
+	unsigned int seed = 1;
+	Game* game = new Game(width, height, seed);
+
+	// end games where the bot circles without eating
+	long hunger = 0;
+	long max_hunger = 4L * width * height;
+
+	auto start = std::chrono::steady_clock::now();
+	for (long i = 0; i < steps; i++) {
+		steer(game);
+		TickResult r = game->tick();
+		hunger = r == TickResult::ATE ? 0 : hunger + 1;
+		if (r == TickResult::GAME_OVER || r == TickResult::VICTORY || hunger > max_hunger) {
+			result.total_score += game->snake->segment_count;
+			result.games++;
+			delete game;
+			game = new Game(width, height, ++seed);
+			hunger = 0;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	result.steps_per_sec = steps / std::chrono::duration<double>(end - start).count();
+	delete game;
+	return result;
+}
+
+/**
+ * Run the benchmark.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero on success, one on bad arguments.
+ */
+int main(int argc, char** argv) {
+	long steps = 20000000;
+	if (argc > 1) {
+		steps = atol(argv[1]);
+	}
+	if (steps < 1) {
+		std::cout << "Usage: BoardBench [ steps ]" << std::endl;
+		return 1;
+	}
+
+	std::cout << steps << " steps per board" << std::endl;
+	std::cout << std::setw(9) << "board" << std::setw(16) << "steps/s" << std::setw(9) << "games"
+	          << std::setw(12) << "avg score" << std::endl;
+
+	int sizes[] = { 10, 20, 32 };
+	for (int size : sizes) {
+		BenchResult r = play(size, size, steps);
+		std::cout << std::setw(9) << (std::to_string(size) + "x" + std::to_string(size))
+		          << std::setw(16) << std::fixed << std::setprecision(0) << r.steps_per_sec
+		          << std::setw(9) << r.games << std::setw(12) << std::setprecision(1)
+		          << (double) r.total_score / std::max(1L, r.games) << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,686 @@
+//============================================================================
+// Name        : LatencyBench.cpp
+// Description : Measures key-to-screen latency of the real SnakeGame binary,
+//               running it under a pseudo-terminal and watching its output
+//               for the Snake's head to turn.
+//============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+
+#include <poll.h>
+#include <pty.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Direction.h"
+
+/**
+ * Get the current time from a monotonic clock.
+ * @return The current time, in microseconds.
+ */
+long now_us() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * The families of movement keys handled by handle_input() in SnakeGame.cpp.
+ */
+enum class KeyFamily {
+	ARROWS, ASWD, HJKL
+};
+
+const char* KEY_FAMILY_NAMES[] = { "arrows", "aswd", "hjkl" };
+
+/**
+ * Get the bytes a terminal sends for a movement key.
+ * @param family The family of keys to use.
+ * @param d The Direction to move in.
+ * @return The bytes of the key press.
+ */
+std::string key_bytes(KeyFamily family, Direction d) {
+	const int i = (int) d;
+	if (family == KeyFamily::ASWD) {
+		return std::string(1, "wsad"[i]);
+	} else if (family == KeyFamily::HJKL) {
+		return std::string(1, "kjhl"[i]);
+	}
+	// the game turns on the keypad, which puts xterm in application mode
+	return std::string("\033O") + "ABDC"[i];
+}
+
+/**
+ * Follows the cursor through the output of ncurses, far enough to know
+ * where each character lands. Colors and other attributes are ignored.
+ */
+struct TerminalTracker {
+	int cols;
+	int rows;
+	int row = 0;
+	int col = 0;
+	int saved_row = 0;
+	int saved_col = 0;
+	char last = ' ';
+
+	// escape sequence state
+	enum class State {
+		TEXT, ESCAPE, CSI, CHARSET, STRING
+	};
+	State state = State::TEXT;
+	std::string params;
+	bool string_escape = false;
+
+	// the head of the Snake, as last drawn
+	bool head_known = false;
+	int head_row = 0;
+	int head_col = 0;
+
+	TerminalTracker(int cols, int rows) :
+			cols(cols), rows(rows) {
+	}
+
+	/**
+	 * Feed bytes written by the game, and collect where it drew the head.
+	 * @param data The bytes.
+	 * @param length The number of bytes.
+	 * @param heads Receives the screen row and column of each '@' drawn.
+	 */
+	void feed(const char* data, size_t length, std::vector<std::pair<int, int>>* heads) {
+		for (size_t i = 0; i < length; i++) {
+			unsigned char c = data[i];
+			switch (state) {
+			case State::TEXT:
+				text(c, heads);
+				break;
+			case State::ESCAPE:
+				escape(c);
+				break;
+			case State::CSI:
+				if (c >= 0x40 && c <= 0x7e) {
+					csi(c, heads);
+					state = State::TEXT;
+				} else {
+					params += c;
+				}
+				break;
+			case State::CHARSET:
+				state = State::TEXT;
+				break;
+			case State::STRING:
+				// an OSC, DCS or similar string, ended by BEL or ESC \.
+				if (c == 0x07 || (string_escape && c == '\\')) {
+					state = State::TEXT;
+				}
+				string_escape = c == 0x1b;
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Handle a byte outside of any escape sequence.
+	 * @param c The byte.
+	 * @param heads Receives the position of an '@'.
+	 */
+	void text(unsigned char c, std::vector<std::pair<int, int>>* heads) {
+		if (c == 0x1b) {
+			state = State::ESCAPE;
+		} else if (c == '\r') {
+			col = 0;
+		} else if (c == '\n') {
+			row = std::min(row + 1, rows - 1);
+		} else if (c == '\b') {
+			col = std::max(col - 1, 0);
+		} else if (c == '\t') {
+			col = std::min((col / 8 + 1) * 8, cols - 1);
+		} else if (c >= 0x20 && c != 0x7f && (c & 0xc0) != 0x80) {
+			// printable, or the first byte of a UTF-8 character
+			put(c, heads);
+		}
+	}
+
+	/**
+	 * Draw a character at the cursor and advance it, wrapping like xterm.
+	 * @param c The character.
+	 * @param heads Receives the position of an '@'.
+	 */
+	void put(unsigned char c, std::vector<std::pair<int, int>>* heads) {
+		if (col >= cols) {
+			col = 0;
+			row = std::min(row + 1, rows - 1);
+		}
+		if (c == '@' && heads != nullptr) {
+			heads->push_back(std::make_pair(row, col));
+		}
+		last = c;
+		col++;
+	}
+
+	/**
+	 * Handle the byte after an ESC.
+	 * @param c The byte.
+	 */
+	void escape(unsigned char c) {
+		state = State::TEXT;
+		if (c == '[') {
+			params.clear();
+			state = State::CSI;
+		} else if (c == '(' || c == ')' || c == '*' || c == '+' || c == '#') {
+			state = State::CHARSET;
+		} else if (c == ']' || c == 'P' || c == '_' || c == '^') {
+			string_escape = false;
+			state = State::STRING;
+		} else if (c == '7') {
+			saved_row = row;
+			saved_col = col;
+		} else if (c == '8') {
+			row = saved_row;
+			col = saved_col;
+		} else if (c == 'M') {
+			row = std::max(row - 1, 0);
+		} else if (c == 'D') {
+			row = std::min(row + 1, rows - 1);
+		} else if (c == 'E') {
+			row = std::min(row + 1, rows - 1);
+			col = 0;
+		}
+	}
+
+	/**
+	 * Get a numeric parameter of the current control sequence.
+	 * @param index Which parameter to get.
+	 * @param fallback The value of a missing or zero parameter.
+	 * @return The parameter.
+	 */
+	int param(int index, int fallback) {
+		size_t begin = 0;
+		if (!params.empty() && (params[0] < '0' || params[0] > ';')) {
+			begin = 1;
+		}
+		for (int i = 0; i < index; i++) {
+			begin = params.find(';', begin);
+			if (begin == std::string::npos) {
+				return fallback;
+			}
+			begin++;
+		}
+		int value = atoi(params.c_str() + begin);
+		return value > 0 ? value : fallback;
+	}
+
+	/**
+	 * Handle the final byte of a control sequence, moving the cursor
+	 * where it says to.
+	 * @param c The final byte.
+	 * @param heads Receives the position of a repeated '@'.
+	 */
+	void csi(unsigned char c, std::vector<std::pair<int, int>>* heads) {
+		if (!params.empty() && params[0] == '?') {
+			// private modes never move the cursor
+			return;
+		}
+		switch (c) {
+		case 'H':
+		case 'f':
+			row = param(0, 1) - 1;
+			col = param(1, 1) - 1;
+			break;
+		case 'A':
+			row -= param(0, 1);
+			break;
+		case 'B':
+		case 'e':
+			row += param(0, 1);
+			break;
+		case 'C':
+		case 'a':
+			col += param(0, 1);
+			break;
+		case 'D':
+			col -= param(0, 1);
+			break;
+		case 'E':
+			row += param(0, 1);
+			col = 0;
+			break;
+		case 'F':
+			row -= param(0, 1);
+			col = 0;
+			break;
+		case 'G':
+		case '`':
+			col = param(0, 1) - 1;
+			break;
+		case 'd':
+			row = param(0, 1) - 1;
+			break;
+		case 'L':
+		case 'M':
+			col = 0;
+			break;
+		case 'b':
+			for (int i = param(0, 1); i > 0; i--) {
+				put(last, heads);
+			}
+			break;
+		case 's':
+			saved_row = row;
+			saved_col = col;
+			break;
+		case 'u':
+			row = saved_row;
+			col = saved_col;
+			break;
+		default:
+			// attributes, erasing, inserting and deleting leave the cursor
+			break;
+		}
+		row = std::max(0, std::min(row, rows - 1));
+		col = std::max(0, std::min(col, cols - 1));
+	}
+};
+
+/**
+ * The command line options.
+ */
+struct BenchArgs {
+	std::string binary = "./SnakeGame";
+	int trials = 50;
+	std::vector<std::string> difficulties = { "easy", "normal", "hard" };
+	std::vector<int> esc_delays = { 100, 250 };
+	int split_us = 0;
+	int cols = 80;
+	int rows = 24;
+	std::string out_path;
+	double max_p99_ms = 0;
+};
+
+/**
+ * The latencies measured for one difficulty and esc_delay.
+ */
+struct BenchResult {
+	std::string difficulty;
+	int esc_delay;
+	std::vector<long> latencies;
+	std::vector<KeyFamily> families;
+	int missed = 0;
+	int restarts = 0;
+};
+
+/**
+ * A running SnakeGame, and the pty it is attached to.
+ */
+struct GameProcess {
+	pid_t pid = -1;
+	int fd = -1;
+};
+
+/**
+ * Start the game under a new pty of the benchmark's size.
+ * @param args The benchmark options.
+ * @param difficulty The difficulty to pass to the game.
+ * @param esc_delay The esc_delay to pass to the game.
+ * @param home The $HOME for the game, so no real scores are recorded.
+ * @return The started game, with a pid of -1 on failure.
+ */
+GameProcess start_game(BenchArgs* args, const std::string& difficulty, int esc_delay,
+        const std::string& home) {
+	GameProcess process;
+	struct winsize size;
+	memset(&size, 0, sizeof(size));
+	size.ws_col = args->cols;
+	size.ws_row = args->rows;
+
+	std::string esc_arg = "--esc_delay=" + std::to_string(esc_delay);
+	process.pid = forkpty(&process.fd, nullptr, nullptr, &size);
+	if (process.pid == 0) {
+		setenv("TERM", "xterm", 1);
+		setenv("HOME", home.c_str(), 1);
+		execl(args->binary.c_str(), args->binary.c_str(), difficulty.c_str(), esc_arg.c_str(),
+		        "--history=0", (char*) nullptr);
+		_exit(127);
+	}
+	return process;
+}
+
+/**
+ * Stop a game and wait for it to exit.
+ * @param process The game to stop.
+ */
+void stop_game(GameProcess* process) {
+	if (process->pid > 0) {
+		kill(process->pid, SIGKILL);
+		waitpid(process->pid, nullptr, 0);
+		close(process->fd);
+	}
+	process->pid = -1;
+	process->fd = -1;
+}
+
+/**
+ * Send a key press to the game. If requested, an escape sequence is
+ * split after its ESC, as a slow connection might deliver it.
+ * @param process The game.
+ * @param key The bytes of the key press.
+ * @param split_us The delay between the ESC and the rest, in microseconds.
+ * @return The time the key press started, in microseconds.
+ */
+long send_key(GameProcess* process, const std::string& key, int split_us) {
+	long sent = now_us();
+	if (split_us > 0 && key.length() > 1 && key[0] == '\033') {
+		if (write(process->fd, key.data(), 1) != 1) {
+			return sent;
+		}
+		usleep(split_us);
+		if (write(process->fd, key.data() + 1, key.length() - 1) < 0) {
+			return sent;
+		}
+	} else if (write(process->fd, key.data(), key.length()) < 0) {
+		return sent;
+	}
+	return sent;
+}
+
+/**
+ * Stop a run of the game that can't go on. A key press still waiting
+ * for its turn counts as a missed turn.
+ * @param result The results to count the missed turn in.
+ * @param process The game to stop.
+ * @param trial The number of turns tried, including missed ones.
+ * @param key_sent The time of the waiting key press, or -1 if none.
+ */
+void end_run(BenchResult* result, GameProcess* process, int* trial, long key_sent) {
+	if (key_sent >= 0) {
+		result->missed++;
+		(*trial)++;
+	}
+	result->restarts++;
+	stop_game(process);
+}
+
+/**
+ * Measure the latency of turning the Snake, for one difficulty and
+ * esc_delay. The Snake runs clockwise around a small square; before each
+ * turn the benchmark waits a random part of the last tick, so key
+ * presses land at every phase of the game's frame loop.
+ * @param args The benchmark options.
+ * @param difficulty The difficulty to measure.
+ * @param esc_delay The esc_delay to measure.
+ * @param home The $HOME for the game.
+ * @return The measured latencies.
+ */
+BenchResult measure(BenchArgs* args, const std::string& difficulty, int esc_delay,
+        const std::string& home) {
+	const int leg = 3;                 // cells to move between turns
+	const long stall_us = 2000 * 1000; // no head movement for this long ends a run
+
+	BenchResult result;
+	result.difficulty = difficulty;
+	result.esc_delay = esc_delay;
+
+	std::mt19937 random_engine(esc_delay * 31 + difficulty.length());
+	std::uniform_real_distribution<double> phase(0.0, 1.0);
+
+	GameProcess process;
+	TerminalTracker* tracker = nullptr;
+	std::vector<std::pair<int, int>> heads;
+	bool have_direction = false;
+	Direction direction = Direction::RIGHT;
+	int moves = 0;
+	long last_move = 0;
+	long tick = 0;
+	long key_due = -1;
+	long key_sent = -1;
+	Direction target = Direction::RIGHT;
+	int trial = 0;
+
+	while (trial < args->trials && result.restarts <= args->trials) {
+		if (process.pid < 0) {
+			process = start_game(args, difficulty, esc_delay, home);
+			if (process.pid < 0) {
+				break;
+			}
+			delete tracker;
+			tracker = new TerminalTracker(args->cols, args->rows);
+			have_direction = false;
+			moves = 0;
+			last_move = now_us();
+			tick = 0;
+			key_due = -1;
+			key_sent = -1;
+		}
+
+		long now = now_us();
+		if (key_due >= 0 && now >= key_due) {
+			KeyFamily family = (KeyFamily) (trial % 3);
+			key_sent = send_key(&process, key_bytes(family, target), args->split_us);
+			key_due = -1;
+			now = now_us();
+		}
+		if (now - last_move > stall_us) {
+			// the Snake crashed, or a key press was lost
+			end_run(&result, &process, &trial, key_sent);
+			continue;
+		}
+
+		int wait_ms = 50;
+		if (key_due >= 0) {
+			wait_ms = std::max(0L, (key_due - now) / 1000);
+		}
+		struct pollfd pfd = { process.fd, POLLIN, 0 };
+		if (poll(&pfd, 1, wait_ms) <= 0) {
+			continue;
+		}
+		char buffer[65536];
+		ssize_t length = read(process.fd, buffer, sizeof(buffer));
+		long received = now_us();
+		if (length <= 0) {
+			// the game exited, as it does for an ESC read on its own
+			end_run(&result, &process, &trial, key_sent);
+			continue;
+		}
+
+		heads.clear();
+		tracker->feed(buffer, length, &heads);
+		for (std::pair<int, int>& head : heads) {
+			int dy = head.first - tracker->head_row;
+			int dx = head.second - tracker->head_col;
+			bool known = tracker->head_known;
+			tracker->head_known = true;
+			tracker->head_row = head.first;
+			tracker->head_col = head.second;
+			if (!known || std::abs(dx) + std::abs(dy) != 1) {
+				continue;
+			}
+			Direction moved = dx < 0 ? Direction::LEFT : dx > 0 ? Direction::RIGHT :
+			                  dy < 0 ? Direction::UP : Direction::DOWN;
+			tick = received - last_move;
+			last_move = received;
+			if (have_direction && moved != direction) {
+				moves = 0;
+			}
+			have_direction = true;
+			direction = moved;
+			moves++;
+
+			if (key_sent >= 0 && moved == target) {
+				result.latencies.push_back(received - key_sent);
+				result.families.push_back((KeyFamily) (trial % 3));
+				key_sent = -1;
+				trial++;
+			} else if (key_sent < 0 && key_due < 0 && moves >= leg && tick > 0) {
+				target = turn_right(direction);
+				key_due = received + (long) (phase(random_engine) * tick);
+			}
+		}
+	}
+	stop_game(&process);
+	delete tracker;
+	return result;
+}
+
+/**
+ * Get a percentile of sorted latencies.
+ * @param sorted The latencies, sorted.
+ * @param p The percentile, from 0 to 100.
+ * @return The latency at the percentile, in milliseconds.
+ */
+double percentile_ms(std::vector<long>& sorted, double p) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t i = (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5);
+	return sorted[i] / 1000.0;
+}
+
+/**
+ * Split a comma separated list.
+ * @param list The list.
+ * @return The items in the list.
+ */
+std::vector<std::string> split(const std::string& list) {
+	std::vector<std::string> items;
+	size_t begin = 0;
+	while (begin <= list.length()) {
+		size_t end = list.find(',', begin);
+		if (end == std::string::npos) {
+			end = list.length();
+		}
+		if (end > begin) {
+			items.push_back(list.substr(begin, end - begin));
+		}
+		begin = end + 1;
+	}
+	return items;
+}
+
+/**
+ * Print the usage info for this benchmark.
+ */
+void print_usage() {
+	std::cout << "Usage: LatencyBench [ path/to/SnakeGame --trials=N --difficulties=list"
+	          << std::endl;
+	std::cout << "                      --esc_delays=list --split_us=N --size=COLSxROWS"
+	          << std::endl;
+	std::cout << "                      --out=file --max_p99_ms=N ]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Defaults to ./SnakeGame, 50 turns for each of easy,normal,hard at esc_delays"
+	          << std::endl;
+	std::cout << "100,250 on an 80x24 terminal. --split_us delays the rest of an arrow key"
+	          << std::endl;
+	std::cout << "after its ESC. --out writes every latency as CSV, and --max_p99_ms fails"
+	          << std::endl;
+	std::cout << "when any 99th percentile is slower." << std::endl;
+}
+
+/**
+ * Run the benchmark.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero on success, one if a turn was missed or too slow.
+ */
+int main(int argc, char** argv) {
+	BenchArgs args;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.rfind("--trials=", 0) == 0) {
+			args.trials = atoi(arg.substr(9).c_str());
+		} else if (arg.rfind("--difficulties=", 0) == 0) {
+			args.difficulties = split(arg.substr(15));
+		} else if (arg.rfind("--esc_delays=", 0) == 0) {
+			args.esc_delays.clear();
+			for (std::string& item : split(arg.substr(13))) {
+				args.esc_delays.push_back(atoi(item.c_str()));
+			}
+		} else if (arg.rfind("--split_us=", 0) == 0) {
+			args.split_us = atoi(arg.substr(11).c_str());
+		} else if (arg.rfind("--size=", 0) == 0) {
+			if (sscanf(arg.c_str() + 7, "%dx%d", &args.cols, &args.rows) != 2) {
+				args.cols = 0;
+			}
+		} else if (arg.rfind("--out=", 0) == 0) {
+			args.out_path = arg.substr(6);
+		} else if (arg.rfind("--max_p99_ms=", 0) == 0) {
+			args.max_p99_ms = atof(arg.substr(13).c_str());
+		} else if (arg.rfind("-", 0) == 0) {
+			print_usage();
+			return arg == "-h" || arg == "--help" ? 0 : 1;
+		} else {
+			args.binary = arg;
+		}
+	}
+	if (args.trials < 1 || args.cols < 20 || args.rows < 10 || args.difficulties.empty()
+	        || args.esc_delays.empty() || args.split_us < 0) {
+		print_usage();
+		return 1;
+	}
+	if (access(args.binary.c_str(), X_OK) != 0) {
+		std::cout << "Unable to run \"" << args.binary << "\"." << std::endl;
+		return 1;
+	}
+
+	// keep benchmark games off the real leaderboard
+	char home_template[] = "/tmp/latencybench.XXXXXX";
+	if (mkdtemp(home_template) == nullptr) {
+		std::cout << "Unable to create a temporary directory." << std::endl;
+		return 1;
+	}
+	std::string home = home_template;
+
+	std::ofstream out;
+	if (args.out_path.length() > 0) {
+		out.open(args.out_path);
+		out << "difficulty,esc_delay,keys,latency_us" << std::endl;
+	}
+
+	std::cout << args.trials << " turns per run, " << args.cols << "x" << args.rows
+	          << " terminal, split_us " << args.split_us << std::endl;
+	std::cout << std::setw(10) << "difficulty" << std::setw(10) << "esc_delay" << std::setw(7)
+	          << "turns" << std::setw(8) << "missed" << std::setw(9) << "min ms" << std::setw(9)
+	          << "p50 ms" << std::setw(9) << "p90 ms" << std::setw(9) << "p99 ms" << std::setw(9)
+	          << "max ms" << std::endl;
+
+	bool failed = false;
+	for (std::string& difficulty : args.difficulties) {
+		for (int esc_delay : args.esc_delays) {
+			BenchResult result = measure(&args, difficulty, esc_delay, home);
+			for (size_t i = 0; out.is_open() && i < result.latencies.size(); i++) {
+				out << difficulty << "," << esc_delay << ","
+				    << KEY_FAMILY_NAMES[(int) result.families[i]] << "," << result.latencies[i]
+				    << std::endl;
+			}
+
+			std::vector<long> sorted = result.latencies;
+			std::sort(sorted.begin(), sorted.end());
+			double p99 = percentile_ms(sorted, 99);
+			std::cout << std::fixed << std::setprecision(1) << std::setw(10) << difficulty
+			          << std::setw(10) << esc_delay << std::setw(7) << sorted.size()
+			          << std::setw(8) << result.missed << std::setw(9) << percentile_ms(sorted, 0)
+			          << std::setw(9) << percentile_ms(sorted, 50) << std::setw(9)
+			          << percentile_ms(sorted, 90) << std::setw(9) << p99 << std::setw(9)
+			          << percentile_ms(sorted, 100) << std::endl;
+
+			if (sorted.empty() || result.missed > 0
+			        || (args.max_p99_ms > 0 && p99 > args.max_p99_ms)) {
+				failed = true;
+			}
+		}
+	}
+
+	std::string scores = home + "/.snakegame";
+	unlink((scores + "/scores.log").c_str());
+	unlink((scores + "/scores.idx").c_str());
+	rmdir(scores.c_str());
+	rmdir(home.c_str());
+	return failed ? 1 : 0;
+}
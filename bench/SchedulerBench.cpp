@@ -0,0 +1,174 @@
+//============================================================================
+// Name        : SchedulerBench.cpp
+// Description : Drives many bot-played Games from one thread with the
+//               Scheduler, and reports the memory each session costs and
+//               how many sessions one thread could keep in real time.
+//============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include "Scheduler.h"
+
+/**
+ * Get the number of bytes allocated on the heap.
+ * @return The bytes in use, as reported by malloc.
+ */
+long heap_bytes() {
+	return mallinfo2().uordblks;
+}
+
+/**
+ * Get the resident set size of this process.
+ * @return The resident set size, in kilobytes.
+ */
+long rss_kb() {
+	long pages = 0;
+	long resident = 0;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (f == nullptr) {
+		return 0;
+	}
+	if (fscanf(f, "%ld %ld", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(f);
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Turn the Snake towards the treasure, or away from whatever it is
+ * about to run into.
+ * @param game The Game to steer.
+ */
+void steer(Game* game) {
+	Snake* snake = game->snake;
+	Point head = snake->head();
+	Direction options[] = { game->treasure.x < head.x ? Direction::LEFT : Direction::RIGHT,
+	        game->treasure.y < head.y ? Direction::UP : Direction::DOWN, snake->direction,
+	        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT };
+	for (Direction d : options) {
+		int x = head.x + DIRECTION_DX[static_cast<int>(d)];
+		int y = head.y + DIRECTION_DY[static_cast<int>(d)];
+		if (!game->is_blocked(x, y)) {
+			if (d != snake->direction) {
+				game->turn(d);
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * Print the usage info for this benchmark.
+ */
+void print_usage() {
+	std::cout << "Usage: SchedulerBench [ sessions seconds board_size ]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Defaults to 10000 sessions on 80x24 boards for 60 seconds of game time,"
+	          << std::endl;
+	std::cout << "simulated as fast as one thread can run them." << std::endl;
+}
+
+/**
+ * Run the benchmark.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero on success, one on bad arguments.
+ */
+int main(int argc, char** argv) {
+	int session_count = 10000;
+	int seconds = 60;
+	int width = 80;
+	int height = 24;
+
+	if (argc > 1 && std::string(argv[1]).rfind("-h", 0) == 0) {
+		print_usage();
+		return 0;
+	}
+	if (argc > 1) {
+		session_count = atoi(argv[1]);
+	}
+	if (argc > 2) {
+		seconds = atoi(argv[2]);
+	}
+	if (argc > 3 && sscanf(argv[3], "%dx%d", &width, &height) != 2) {
+		width = 0;
+	}
+	if (session_count < 1 || seconds < 1 || width < 2 || height < 2) {
+		print_usage();
+		return 1;
+	}
+
+	// the clock is simulated, so the run is as fast as the ticks allow
+	int64_t now = 0;
+	long heap_before = heap_bytes();
+	long rss_before = rss_kb();
+	Scheduler scheduler(now);
+	unsigned int seed = 1;
+	for (int i = 0; i < session_count; i++) {
+		Game* game = new Game(width, height, seed++);
+		game->difficulty = (Difficulty) (i % 3);
+		scheduler.add(game);
+	}
+	long heap_after = heap_bytes();
+	long rss_after = rss_kb();
+
+	// bots play, and a Game that ends is replaced by a new one
+	long games_ended = 0;
+	scheduler.on_tick = [&](int id, Game* game, TickResult result) {
+		if (result == TickResult::GAME_OVER || result == TickResult::VICTORY) {
+			Difficulty difficulty = game->difficulty;
+			scheduler.remove(id);
+			delete game;
+			games_ended++;
+			Game* next = new Game(width, height, seed++);
+			next->difficulty = difficulty;
+			scheduler.add(next);
+		} else {
+			steer(game);
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	int64_t end = (int64_t) seconds * 1000000;
+	while (now < end) {
+		int64_t deadline = scheduler.next_deadline();
+		now = deadline < 0 || deadline > end ? end : deadline;
+		scheduler.run_until(now);
+	}
+	double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	long heap_end = heap_bytes();
+	double per_session = (double) (heap_after - heap_before) / session_count;
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "sessions            " << session_count << " on one thread, " << width << "x"
+	          << height << " boards" << std::endl;
+	std::cout << "memory per session  " << per_session << " bytes of heap at the start ("
+	          << sizeof(Game) << " for the Game, " << sizeof(Snake) << " for the Snake, "
+	          << sizeof(Session) << " for the Session)" << std::endl;
+	std::cout << "                    " << (double) (heap_end - heap_before) / session_count
+	          << " bytes of heap at the end, with grown snakes" << std::endl;
+	std::cout << "                    " << (double) (rss_after - rss_before) * 1024 / session_count
+	          << " bytes of resident memory at the start" << std::endl;
+	std::cout << "game time           " << seconds << " s in " << wall << " s of wall time"
+	          << std::endl;
+	std::cout << "ticks               " << scheduler.ticks << " ("
+	          << (long) (scheduler.ticks / wall) << " per second), " << games_ended
+	          << " games ended and replaced" << std::endl;
+	std::cout << "real-time capacity  " << (long) (session_count * seconds / wall)
+	          << " sessions per thread at this tick mix" << std::endl;
+
+	for (Session& session : scheduler.sessions) {
+		delete session.game;
+	}
+	return 0;
+}
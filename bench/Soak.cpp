@@ -0,0 +1,354 @@
+//============================================================================
+// Name        : Soak.cpp
+// Description : Plays the game headlessly for a long run of ticks, tracking
+//               memory and throughput over time and checking the Snake's
+//               invariants. Writes the samples as CSV and fails on leaks
+//               or slowdowns.
+//============================================================================
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <unistd.h>
+
+#include "Game.h"
+#include "History.h"
+#include "Snapshot.h"
+
+/**
+ * Live heap allocations, counted by the operator new/delete below.
+ */
+std::atomic<long> live_allocations(0);
+std::atomic<long> total_allocations(0);
+
+void* operator new(size_t size) {
+	void* p = malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	live_allocations++;
+	total_allocations++;
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	if (p != nullptr) {
+		live_allocations--;
+		free(p);
+	}
+}
+
+void operator delete[](void* p) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	operator delete(p);
+}
+
+/**
+ * Get the resident set size of this process.
+ * @return The resident set size, in kilobytes.
+ */
+long rss_kb() {
+	long pages = 0;
+	long resident = 0;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (f == nullptr) {
+		return 0;
+	}
+	if (fscanf(f, "%ld %ld", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(f);
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Check that the Snake's ring holds segment_count adjacent cells,
+ * matching its occupancy Grid exactly.
+ * @param snake The Snake to check.
+ * @return A description of the first broken invariant, or an empty string.
+ */
+std::string check_snake(Snake* snake) {
+	size_t capacity = snake->body.size();
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		return "the ring's capacity is not a power of two";
+	}
+	if (snake->segment_count < 1 || (size_t) snake->segment_count > capacity) {
+		return "segment_count does not fit the ring";
+	}
+	if (snake->head_index >= capacity) {
+		return "head_index is outside the ring";
+	}
+	for (int i = 0; i < snake->segment_count; i++) {
+		Point p = snake->segment(i);
+		if (i > 0) {
+			Point prev = snake->segment(i - 1);
+			if (abs(p.x - prev.x) + abs(p.y - prev.y) != 1) {
+				return "segment " + std::to_string(i) + " is not adjacent to the one before it";
+			}
+		}
+		if (!snake->occupied.get(p.x, p.y)) {
+			return "segment " + p.to_string() + " is missing from the grid";
+		}
+	}
+	long occupied = 0;
+	for (auto& entry : snake->occupied.chunks) {
+		occupied += entry.second->count;
+		if (entry.second->count == 0) {
+			return "the grid holds an empty chunk";
+		}
+	}
+	if (occupied != snake->segment_count) {
+		return "the grid holds cells outside the body";
+	}
+	return "";
+}
+
+/**
+ * Turn the Snake towards the treasure, or away from whatever it is
+ * about to run into.
+ * @param game The Game to steer.
+ */
+void steer(Game* game) {
+	Snake* snake = game->snake;
+	int hx = snake->head().x;
+	int hy = snake->head().y;
+	int tx = game->treasure.x;
+	int ty = game->treasure.y;
+
+	Direction options[7];
+	int count = 0;
+	if (tx != hx) {
+		options[count++] = tx < hx ? Direction::LEFT : Direction::RIGHT;
+	}
+	if (ty != hy) {
+		options[count++] = ty < hy ? Direction::UP : Direction::DOWN;
+	}
+	options[count++] = snake->direction;
+	options[count++] = Direction::UP;
+	options[count++] = Direction::DOWN;
+	options[count++] = Direction::LEFT;
+	options[count++] = Direction::RIGHT;
+
+	for (int i = 0; i < count; i++) {
+		int x = hx + DIRECTION_DX[static_cast<int>(options[i])];
+		int y = hy + DIRECTION_DY[static_cast<int>(options[i])];
+		if (!game->is_blocked(x, y)) {
+			snake->direction = options[i];
+			return;
+		}
+	}
+}
+
+/**
+ * One row of the time series.
+ */
+struct Sample {
+	double seconds;
+	long ticks;
+	double ticks_per_sec;
+	long rss_kb;
+	long live_allocations;
+	long baseline_allocations;
+	long games;
+};
+
+/**
+ * Check whether a series grows at every step after the warmup samples.
+ * @param values The series.
+ * @param warmup The number of leading samples to ignore.
+ * @return true if every later value is larger than the one before it.
+ */
+bool monotonic_growth(std::vector<long>& values, unsigned int warmup) {
+	if (values.size() < warmup + 4) {
+		return false;
+	}
+	for (unsigned int i = warmup + 1; i < values.size(); i++) {
+		if (values[i] <= values[i - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Print the usage info for the soak harness.
+ */
+void print_usage() {
+	std::cout << "Usage: Soak [ --ticks=N --interval=N --out=file ]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "\"--ticks=N\" total ticks to simulate, defaults to 200000000." << std::endl;
+	std::cout << "\"--interval=N\" ticks between samples, defaults to 5000000." << std::endl;
+	std::cout << "\"--out=file\" the CSV time series, defaults to soak.csv." << std::endl;
+}
+
+/**
+ * Run the soak.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero if no leak, slowdown or broken invariant was found, else one.
+ */
+int main(int argc, char** argv) {
+	long total_ticks = 200000000;
+	long interval = 5000000;
+	std::string out_path = "soak.csv";
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.rfind("--ticks=", 0) == 0) {
+			total_ticks = atol(arg.substr(8).c_str());
+		} else if (arg.rfind("--interval=", 0) == 0) {
+			interval = atol(arg.substr(11).c_str());
+		} else if (arg.rfind("--out=", 0) == 0) {
+			out_path = arg.substr(6);
+		} else {
+			print_usage();
+			return 1;
+		}
+	}
+	if (total_ticks < 1 || interval < 1) {
+		print_usage();
+		return 1;
+	}
+
+	std::ofstream out(out_path);
+	out << "seconds,ticks,ticks_per_sec,rss_kb,live_allocations,baseline_allocations,games"
+	    << std::endl;
+
+	// board sizes to rotate through, one per game
+	const int sizes[][2] = { { 10, 10 }, { 40, 20 }, { 80, 24 }, { 200, 60 }, { 1000, 1000 } };
+	const int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+	std::vector<Sample> samples;
+	std::string failure;
+	long games = 0;
+	long baseline = live_allocations;
+	unsigned int seed = 1;
+
+	auto start = std::chrono::steady_clock::now();
+	auto last_sample = start;
+	long last_sample_ticks = 0;
+
+	Game* game = new Game(sizes[0][0], sizes[0][1], seed);
+	History* history = new History(1000);
+
+	for (long tick = 1; tick <= total_ticks && failure.empty(); tick++) {
+		steer(game);
+		TickResult result = game->tick();
+		history->record(game, result);
+
+		// exercise rewinding and snapshots along the way
+		if (tick % 5000 == 0 && result != TickResult::GAME_OVER) {
+			history->seek(game, history->cursor - 50);
+			failure = check_snake(game->snake);
+			history->seek(game, history->last);
+		}
+		if (tick % 20000 == 0 && result != TickResult::GAME_OVER) {
+			Game* clone = clone_game(game);
+			if (clone == nullptr || encode_snapshot(clone) != encode_snapshot(game)) {
+				failure = "a cloned game differs from the original";
+			}
+			delete clone;
+		}
+
+		if (result == TickResult::GAME_OVER || result == TickResult::VICTORY) {
+			if (failure.empty()) {
+				failure = check_snake(game->snake);
+			}
+			delete game;
+			delete history;
+			games++;
+
+			// whatever is still allocated between games is not owned by any game
+			baseline = live_allocations;
+
+			seed++;
+			const int* size = sizes[games % size_count];
+			game = new Game(size[0], size[1], seed);
+			history = new History(1000);
+		} else if (tick % 100000 == 0 && failure.empty()) {
+			failure = check_snake(game->snake);
+		}
+
+		if (tick % interval == 0) {
+			auto now = std::chrono::steady_clock::now();
+			Sample s;
+			s.seconds = std::chrono::duration<double>(now - start).count();
+			s.ticks = tick;
+			s.ticks_per_sec = (tick - last_sample_ticks)
+			        / std::chrono::duration<double>(now - last_sample).count();
+			s.rss_kb = rss_kb();
+			s.live_allocations = live_allocations;
+			s.baseline_allocations = baseline;
+			s.games = games;
+			samples.push_back(s);
+			last_sample = now;
+			last_sample_ticks = tick;
+
+			out << s.seconds << "," << s.ticks << "," << s.ticks_per_sec << "," << s.rss_kb << ","
+			    << s.live_allocations << "," << s.baseline_allocations << "," << s.games
+			    << std::endl;
+			std::cout << "ticks " << s.ticks << "  " << (long) s.ticks_per_sec << " ticks/s  rss "
+			          << s.rss_kb << " KB  live " << s.live_allocations << "  baseline "
+			          << s.baseline_allocations << "  games " << s.games << std::endl;
+		}
+	}
+	delete game;
+	delete history;
+
+	// fail on memory that grows at every sample, or on a slowdown
+	// compared with the early samples
+	const unsigned int warmup = 2;
+	std::vector<long> rss;
+	std::vector<long> baselines;
+	for (Sample& s : samples) {
+		rss.push_back(s.rss_kb);
+		baselines.push_back(s.baseline_allocations);
+	}
+	// no game is alive when the baseline is taken, so once the one-off
+	// allocations of the warmup are done it must not grow at all
+	if (failure.empty() && samples.size() > warmup
+	        && baselines.back() > baselines[warmup]) {
+		failure = "live allocations between games grew from " + std::to_string(baselines[warmup])
+		        + " to " + std::to_string(baselines.back());
+	}
+	if (failure.empty() && monotonic_growth(rss, warmup)) {
+		failure = "resident memory grew at every sample";
+	}
+	if (failure.empty() && samples.size() >= 2 * (warmup + 2)) {
+		double early = 0;
+		double late = 0;
+		unsigned int window = (samples.size() - warmup) / 2;
+		for (unsigned int i = 0; i < window; i++) {
+			early += samples[warmup + i].ticks_per_sec;
+			late += samples[samples.size() - window + i].ticks_per_sec;
+		}
+		if (late < 0.7 * early) {
+			failure = "throughput fell by more than 30%";
+		}
+	}
+
+	if (!failure.empty()) {
+		std::cout << "FAILED: " << failure << std::endl;
+		return 1;
+	}
+	std::cout << "OK: " << samples.size() << " samples written to " << out_path << std::endl;
+	return 0;
+}
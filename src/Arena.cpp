@@ -0,0 +1,353 @@
+/*
+ * Arena.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include <climits>
+#include <cstdlib>
+
+#include "Arena.h"
+
+/**
+ * Get a key identifying a cell, for use in hash maps.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ * @return The key of the cell.
+ */
+static uint64_t cell_key(int x, int y) {
+	return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y;
+}
+
+/**
+ * Create an Arena with Snakes of length one and treasures placed
+ * on random free cells.
+ * @param width The width of the board.
+ * @param height The height of the board.
+ * @param snake_count The number of Snakes.
+ * @param treasure_count The number of treasures kept on the board.
+ * @param threads The number of threads used by the propose phase.
+ * @param seed The seed to use for RNG.
+ */
+Arena::Arena(int width, int height, int snake_count, int treasure_count, int threads,
+        unsigned int seed) :
+		snakes(snake_count), treasures(treasure_count), proposals(snake_count) {
+	this->width = width;
+	this->height = height;
+	free_cells = (long) width * height;
+	random_engine.seed(seed);
+
+	for (int i = 0; i < snake_count; i++) {
+		spawn(i);
+	}
+	for (int i = 0; i < treasure_count; i++) {
+		place_treasure(i);
+	}
+	for (int w = 1; w < threads; w++) {
+		workers.push_back(std::thread(&Arena::worker_loop, this, w));
+	}
+}
+
+Arena::~Arena() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start_cv.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	for (Snake* snake : snakes) {
+		if (snake != nullptr) {
+			release(snake);
+		}
+	}
+}
+
+/**
+ * Advance every Snake by one move.
+ */
+void Arena::tick() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation++;
+		pending = workers.size();
+	}
+	start_cv.notify_all();
+	propose(0);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done_cv.wait(lock, [this] { return pending == 0; });
+	}
+	resolve();
+	tick_count++;
+}
+
+/**
+ * Turn a player's Snake, unless it is already heading along the
+ * same axis or waiting to respawn. Takes effect at the next tick.
+ * @param i The index of the player's Snake, below players.
+ * @param direction The Direction to turn to.
+ */
+void Arena::turn(int i, Direction direction) {
+	Snake* snake = snakes[i];
+	if (snake != nullptr && can_turn(snake->direction, direction)) {
+		snake->direction = direction;
+	}
+}
+
+/**
+ * Get the combined length of all Snakes, e.g. to check that two
+ * runs with different thread counts reached the same state.
+ * @return The sum of every Snake's segment_count.
+ */
+long Arena::total_length() {
+	long total = 0;
+	for (Snake* snake : snakes) {
+		if (snake != nullptr) {
+			total += snake->segment_count;
+		}
+	}
+	return total;
+}
+
+/**
+ * Run the propose phase on a worker thread, once per generation.
+ * @param worker The index of the worker, from 1.
+ */
+void Arena::worker_loop(int worker) {
+	long seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_cv.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+		propose(worker);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending--;
+			if (pending == 0) {
+				done_cv.notify_one();
+			}
+		}
+	}
+}
+
+/**
+ * Fill in the Proposals of one worker's share of the Snakes.
+ * Each bot keeps going or turns, whichever free cell brings it
+ * closest to its treasure, and each player keeps going the way it was
+ * turned. Only shared state is read here.
+ * @param worker The index of the worker, 0 for the calling thread.
+ */
+void Arena::propose(int worker) {
+	long count = snakes.size();
+	long threads = workers.size() + 1;
+	long begin = count * worker / threads;
+	long end = count * (worker + 1) / threads;
+
+	for (long i = begin; i < end; i++) {
+		Snake* snake = snakes[i];
+		if (snake == nullptr) {
+			continue;
+		}
+		Point head = snake->head();
+		Point target = head;
+		if (!treasures.empty() && treasures[i % treasures.size()].x >= 0) {
+			target = treasures[i % treasures.size()];
+		}
+		Direction options[] = { snake->direction, turn_left(snake->direction),
+		        turn_right(snake->direction) };
+		int option_count = i < players ? 1 : 3;
+
+		Proposal best;
+		long best_score = LONG_MAX;
+		for (int o = 0; o < option_count; o++) {
+			Direction d = options[o];
+			int x = head.x + DIRECTION_DX[static_cast<int>(d)];
+			int y = head.y + DIRECTION_DY[static_cast<int>(d)];
+			bool blocked = x < 0 || x >= width || y < 0 || y >= height || occupied.get(x, y);
+			long score = blocked ? LONG_MAX - 1 : labs(target.x - x) + labs(target.y - y);
+			if (score < best_score) {
+				best = { x, y, d };
+				best_score = score;
+			}
+		}
+		proposals[i] = best;
+	}
+}
+
+/**
+ * Kill the Snakes whose Proposals conflict, move the others, and
+ * respawn the dead Snakes and the eaten treasures where there is
+ * room.
+ */
+void Arena::resolve() {
+	int count = snakes.size();
+
+	// head-to-head: every Snake claiming a contested cell dies
+	std::unordered_map<uint64_t, int> claims;
+	claims.reserve(count * 2);
+	for (int i = 0; i < count; i++) {
+		if (snakes[i] != nullptr) {
+			claims[cell_key(proposals[i].x, proposals[i].y)]++;
+		}
+	}
+
+	std::vector<bool> dead(count);
+	for (int i = 0; i < count; i++) {
+		if (snakes[i] == nullptr) {
+			continue;
+		}
+		Proposal& p = proposals[i];
+		dead[i] = p.x < 0 || p.x >= width || p.y < 0 || p.y >= height
+		        || occupied.get(p.x, p.y) || claims[cell_key(p.x, p.y)] > 1;
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (dead[i]) {
+			release(snakes[i]);
+			snakes[i] = nullptr;
+		}
+	}
+
+	std::vector<int> eaten;
+	for (int i = 0; i < count; i++) {
+		if (dead[i] || snakes[i] == nullptr) {
+			continue;
+		}
+		Proposal& p = proposals[i];
+		Snake* snake = snakes[i];
+		snake->direction = p.direction;
+
+		auto treasure = treasure_index.find(cell_key(p.x, p.y));
+		if (treasure != treasure_index.end()) {
+			eaten.push_back(treasure->second);
+			treasures[treasure->second] = Point(-1, -1);
+			treasure_index.erase(treasure);
+			free_cells++;
+			snake->grow(Point(p.x, p.y));
+		} else {
+			Point tail = snake->tail();
+			occupied.clear(tail.x, tail.y);
+			free_cells++;
+			snake->move(Point(p.x, p.y));
+		}
+		occupied.set(p.x, p.y);
+		free_cells--;
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (dead[i]) {
+			deaths++;
+			if (i < players) {
+				player_deaths++;
+			}
+		}
+	}
+	treasures_eaten += eaten.size();
+
+	// respawn the dead Snakes, and any still waiting for room
+	for (int i = 0; i < count; i++) {
+		if (snakes[i] == nullptr) {
+			spawn(i);
+		}
+	}
+	for (int i = 0; i < (int) treasures.size(); i++) {
+		if (treasures[i].x < 0) {
+			place_treasure(i);
+		}
+	}
+}
+
+/**
+ * Create Snake i with a single cell on a random free cell, or
+ * leave it null if no cell is free.
+ * @param i The index of the Snake.
+ */
+void Arena::spawn(int i) {
+	Point start;
+	if (!random_free_cell(&start)) {
+		snakes[i] = nullptr;
+		return;
+	}
+	Snake* snake = new Snake();
+	snake->track_cells = false;
+	snake->direction = (Direction) std::uniform_int_distribution<int>(0, 3)(random_engine);
+	snake->grow(start);
+	occupied.set(start.x, start.y);
+	free_cells--;
+	snakes[i] = snake;
+}
+
+/**
+ * Move treasure i to a random free cell, or off the board to
+ * (-1, -1) if no cell is free.
+ * @param i The index of the treasure.
+ */
+void Arena::place_treasure(int i) {
+	Point p;
+	if (!random_free_cell(&p)) {
+		treasures[i] = Point(-1, -1);
+		return;
+	}
+	treasures[i] = p;
+	treasure_index[cell_key(p.x, p.y)] = i;
+	free_cells--;
+}
+
+/**
+ * Get a random cell holding neither a Snake nor a treasure. A few
+ * random guesses find one on a mostly empty board; after that the
+ * cells are scanned from a random start, so a crowded board costs
+ * at most one pass.
+ * @param cell Set to the free cell.
+ * @return true if a cell was free.
+ */
+bool Arena::random_free_cell(Point* cell) {
+	if (free_cells <= 0) {
+		return false;
+	}
+	std::uniform_int_distribution<int> width_dist(0, width - 1);
+	std::uniform_int_distribution<int> height_dist(0, height - 1);
+	int x = 0;
+	int y = 0;
+	for (int attempt = 0; attempt < 64; attempt++) {
+		x = width_dist(random_engine);
+		y = height_dist(random_engine);
+		if (!occupied.get(x, y) && treasure_index.count(cell_key(x, y)) == 0) {
+			*cell = Point(x, y);
+			return true;
+		}
+	}
+	long area = (long) width * height;
+	long start = (long) y * width + x;
+	for (long k = 1; k < area; k++) {
+		long index = (start + k) % area;
+		x = index % width;
+		y = index / width;
+		if (!occupied.get(x, y) && treasure_index.count(cell_key(x, y)) == 0) {
+			*cell = Point(x, y);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Remove a Snake from the board and free it.
+ * @param snake The Snake to release.
+ */
+void Arena::release(Snake* snake) {
+	for (int i = 0; i < snake->segment_count; i++) {
+		Point p = snake->segment(i);
+		occupied.clear(p.x, p.y);
+	}
+	free_cells += snake->segment_count;
+	delete snake;
+}
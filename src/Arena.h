@@ -0,0 +1,185 @@
+/*
+ * Arena.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <stdbool.h>
+#include "Point.h"
+#include "Snake.h"
+#include "Grid.h"
+
+/**
+ * The most bots allowed by the --arena game mode.
+ */
+#define ARENA_MAX_BOTS 10000
+
+/**
+ * The fewest cells per Snake the --arena game mode allows, so the
+ * Snakes have room to grow.
+ */
+#define ARENA_CELLS_PER_SNAKE 16
+
+/**
+ * The cell a Snake intends to move into during the current tick.
+ */
+struct Proposal {
+	int x;
+	int y;
+	Direction direction;
+};
+
+/**
+ * Many Snakes, bots and players, sharing one board.
+ *
+ * Each tick runs in two phases. In the propose phase every Snake picks
+ * its next cell by reading the shared occupancy Grid; the Snakes are
+ * split across worker threads since nothing is written. In the resolve
+ * phase, on the calling thread, Snakes whose cells are out of bounds,
+ * occupied, or claimed by more than one Snake die, and the survivors
+ * move. The outcome never depends on the number of threads.
+ *
+ * The Snakes don't track their own cells; the shared Grid is the only
+ * record of them. The first players Snakes are steered with turn()
+ * instead of by the bot, and like the bots they respawn when they die.
+ *
+ * A Snake or treasure with no free cell to go to waits off the board,
+ * as a null Snake or a treasure at (-1, -1), and is placed on a later
+ * tick once a cell frees up.
+ */
+struct Arena {
+	int width = 0;
+	int height = 0;
+	std::vector<Snake*> snakes;
+	std::vector<Point> treasures;
+	std::vector<Proposal> proposals;
+	int players = 0;
+
+	/**
+	 * Every cell covered by any Snake.
+	 */
+	Grid occupied;
+
+	/**
+	 * The number of cells holding neither a Snake nor a treasure.
+	 */
+	long free_cells = 0;
+
+	/**
+	 * The index in treasures of the treasure on each treasure cell.
+	 */
+	std::unordered_map<uint64_t, int> treasure_index;
+
+	long tick_count = 0;
+	long deaths = 0;
+	long player_deaths = 0;
+	long treasures_eaten = 0;
+
+	std::default_random_engine random_engine;
+
+	/**
+	 * Create an Arena with Snakes of length one and treasures placed
+	 * on random free cells.
+	 * @param width The width of the board.
+	 * @param height The height of the board.
+	 * @param snake_count The number of Snakes.
+	 * @param treasure_count The number of treasures kept on the board.
+	 * @param threads The number of threads used by the propose phase.
+	 * @param seed The seed to use for RNG.
+	 */
+	Arena(int width, int height, int snake_count, int treasure_count, int threads,
+	        unsigned int seed);
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	~Arena();
+
+	/**
+	 * Advance every Snake by one move.
+	 */
+	void tick();
+
+	/**
+	 * Turn a player's Snake, unless it is already heading along the
+	 * same axis or waiting to respawn. Takes effect at the next tick.
+	 * @param i The index of the player's Snake, below players.
+	 * @param direction The Direction to turn to.
+	 */
+	void turn(int i, Direction direction);
+
+	/**
+	 * Get the combined length of all Snakes, e.g. to check that two
+	 * runs with different thread counts reached the same state.
+	 * @return The sum of every Snake's segment_count.
+	 */
+	long total_length();
+
+	/**
+	 * Worker threads running the propose phase, and the state used to
+	 * start them and wait for them once per tick.
+	 */
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable start_cv;
+	std::condition_variable done_cv;
+	long generation = 0;
+	int pending = 0;
+	bool stopping = false;
+
+	/**
+	 * Run the propose phase on a worker thread, once per generation.
+	 * @param worker The index of the worker, from 1.
+	 */
+	void worker_loop(int worker);
+
+	/**
+	 * Fill in the Proposals of one worker's share of the Snakes.
+	 * @param worker The index of the worker, 0 for the calling thread.
+	 */
+	void propose(int worker);
+
+	/**
+	 * Kill the Snakes whose Proposals conflict, move the others, and
+	 * respawn the dead Snakes and the eaten treasures where there is
+	 * room.
+	 */
+	void resolve();
+
+	/**
+	 * Create Snake i with a single cell on a random free cell, or
+	 * leave it null if no cell is free.
+	 * @param i The index of the Snake.
+	 */
+	void spawn(int i);
+
+	/**
+	 * Move treasure i to a random free cell, or off the board to
+	 * (-1, -1) if no cell is free.
+	 * @param i The index of the treasure.
+	 */
+	void place_treasure(int i);
+
+	/**
+	 * Get a random cell holding neither a Snake nor a treasure.
+	 * @param cell Set to the free cell.
+	 * @return true if a cell was free.
+	 */
+	bool random_free_cell(Point* cell);
+
+	/**
+	 * Remove a Snake from the board and free it.
+	 * @param snake The Snake to release.
+	 */
+	void release(Snake* snake);
+};
+
+#endif /* ARENA_H_ */
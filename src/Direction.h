@@ -0,0 +1,83 @@
+/*
+ * Direction.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef DIRECTION_H_
+#define DIRECTION_H_
+
+#include <stdbool.h>
+
+/**
+ * Represents the four basic directions.
+ */
+enum class Direction {
+	UP, DOWN, LEFT, RIGHT
+};
+
+/**
+ * The x and y offsets of a single move in each Direction,
+ * indexed by the Direction's underlying value.
+ */
+constexpr int DIRECTION_DX[] = { 0, 0, -1, 1 };
+constexpr int DIRECTION_DY[] = { -1, 1, 0, 0 };
+
+/**
+ * Check whether a Direction runs along the horizontal axis.
+ * @param d The Direction to check.
+ * @return true for LEFT and RIGHT.
+ */
+inline bool horizontal(Direction d) {
+	return d == Direction::LEFT || d == Direction::RIGHT;
+}
+
+/**
+ * Check whether a Snake heading one way may turn to another. A Snake
+ * can only turn onto the other axis, never reverse into itself.
+ * @param heading The Direction the Snake is heading.
+ * @param d The Direction to turn to.
+ * @return true if the turn is allowed.
+ */
+inline bool can_turn(Direction heading, Direction d) {
+	return horizontal(heading) != horizontal(d);
+}
+
+/**
+ * Get the Direction 90 degrees counter-clockwise of the input Direction.
+ * @param d The Direction to turn from.
+ * @return The Direction to the left of d.
+ */
+inline Direction turn_left(Direction d) {
+	switch (d) {
+	case Direction::UP:
+		return Direction::LEFT;
+	case Direction::LEFT:
+		return Direction::DOWN;
+	case Direction::DOWN:
+		return Direction::RIGHT;
+	default:
+		return Direction::UP;
+	}
+}
+
+/**
+ * Get the Direction 90 degrees clockwise of the input Direction.
+ * @param d The Direction to turn from.
+ * @return The Direction to the right of d.
+ */
+inline Direction turn_right(Direction d) {
+	switch (d) {
+	case Direction::UP:
+		return Direction::RIGHT;
+	case Direction::RIGHT:
+		return Direction::DOWN;
+	case Direction::DOWN:
+		return Direction::LEFT;
+	default:
+		return Direction::UP;
+	}
+}
+
+#endif /* DIRECTION_H_ */
@@ -0,0 +1,230 @@
+/*
+ * Game.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include "Game.h"
+
+/**
+ * Create a new Game with the Snake centered on the board
+ * and the first treasure already placed.
+ * @param width The width of the board.
+ * @param height The height of the board.
+ * @param seed The seed to use for RNG.
+ */
+Game::Game(int width, int height, unsigned int seed) {
+	this->width = width;
+	this->height = height;
+
+	// initialize RNG
+	random_engine.seed(seed);
+	width_dist = std::uniform_int_distribution<int>(0, width - 1);
+	height_dist = std::uniform_int_distribution<int>(0, height - 1);
+
+	// initialize the Snake
+	snake = new Snake();
+	snake->direction = Direction::RIGHT;
+	snake->grow(Point(width / 2, height / 2));
+
+	// generate first treasure, unless the Snake already fills the board
+	if ((long long) width * height > 1) {
+		place_treasure();
+	} else {
+		treasure = Point(-1, -1);
+	}
+}
+
+/**
+ * Create a new Game on a Level, with the Snake on the Level's start
+ * cell and the first treasure already placed.
+ * @param level The Level to play on, which must outlive the Game.
+ * @param seed The seed to use for RNG.
+ */
+Game::Game(Level* level, unsigned int seed) {
+	width = level->width;
+	height = level->height;
+
+	// initialize RNG
+	random_engine.seed(seed);
+	width_dist = std::uniform_int_distribution<int>(0, width - 1);
+	height_dist = std::uniform_int_distribution<int>(0, height - 1);
+
+	// initialize the Snake
+	snake = new Snake();
+	snake->direction = Direction::RIGHT;
+	set_level(level);
+	snake->grow(Point(level->start_x, level->start_y));
+
+	// generate first treasure, unless the Snake already fills the level
+	if (level->open_cells > 1) {
+		place_treasure();
+	} else {
+		treasure = Point(-1, -1);
+	}
+}
+
+Game::~Game() {
+	delete snake;
+	if (cells != nullptr) {
+		level->unmap_cells(cells);
+	}
+}
+
+/**
+ * Get the number of microseconds between ticks for a Snake heading in
+ * the given Direction. Vertical moves are slower, since terminal cells
+ * are taller than they are wide, unless sync_frame_rate is set.
+ * @param difficulty The difficulty setting.
+ * @param sync_frame_rate true to use the vertical rate for both axes.
+ * @param direction The Direction the Snake is heading.
+ * @return The delay before the next tick, in microseconds.
+ */
+long tick_interval(Difficulty difficulty, bool sync_frame_rate, Direction direction) {
+	long sleep_ms_horizontal;
+	long sleep_ms_vertical;
+
+	if (difficulty == Difficulty::EASY) {
+		sleep_ms_horizontal = 66 * 1000;
+		sleep_ms_vertical = 110 * 1000;
+	} else if (difficulty == Difficulty::HARD) {
+		sleep_ms_horizontal = 22 * 1000;
+		sleep_ms_vertical = 34 * 1000;
+	} else {
+		sleep_ms_horizontal = 44 * 1000;
+		sleep_ms_vertical = 77 * 1000;
+	}
+
+	if (sync_frame_rate) {
+		sleep_ms_horizontal = sleep_ms_vertical;
+	}
+
+	if (horizontal(direction)) {
+		return sleep_ms_horizontal;
+	} else {
+		return sleep_ms_vertical;
+	}
+}
+
+/**
+ * Get the number of microseconds to wait before the next tick,
+ * based on the difficulty and the Snake's current Direction.
+ * @return The delay before the next tick, in microseconds.
+ */
+long Game::tick_interval() {
+	return ::tick_interval(difficulty, sync_frame_rate, snake->direction);
+}
+
+/**
+ * Turn the Snake and unpause the Game, unless the Snake is already
+ * heading along the same axis.
+ * @param direction The Direction to turn to.
+ */
+void Game::turn(Direction direction) {
+	if (can_turn(snake->direction, direction)) {
+		snake->direction = direction;
+		snake->pause = false;
+	}
+}
+
+/**
+ * Pause the Game, or unpause it if paused.
+ */
+void Game::toggle_pause() {
+	snake->pause = !snake->pause;
+}
+
+/**
+ * Advance the Game by one frame.
+ * @return What happened during this frame.
+ */
+TickResult Game::tick() {
+	if (snake->pause) {
+		return TickResult::PAUSED;
+	}
+
+	Point next_move = snake->get_next_move();
+
+	// check for game over conditions
+	if (is_blocked(next_move.x, next_move.y)) {
+		snake->game_over = true;
+		return TickResult::GAME_OVER;
+	}
+
+	// check for collision with treasure
+	if (next_move.equals(&treasure)) {
+		snake->grow(next_move);
+
+		// check for victory condition
+		long long max_length = (long long) width * height;
+		if (level != nullptr) {
+			max_length = level->open_cells;
+		}
+		if (snake->segment_count == max_length) {
+			snake->game_over = true;
+			return TickResult::VICTORY;
+		}
+
+		// generate new treasure
+		place_treasure();
+		return TickResult::ATE;
+	}
+
+	vacated = snake->tail();
+	snake->move(next_move);
+	return TickResult::MOVED;
+}
+
+/**
+ * Check whether moving onto a cell would end the game.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ * @return true if the cell is off the board, a wall, or covered by the Snake.
+ */
+bool Game::is_blocked(int x, int y) {
+	if ((unsigned) x >= (unsigned) width || (unsigned) y >= (unsigned) height) {
+		return true;
+	}
+	if (cells != nullptr) {
+		return cells[(size_t) y * width + x] & (LEVEL_CELL_WALL | LEVEL_CELL_BODY);
+	}
+	if (level != nullptr && level->wall(x, y)) {
+		return true;
+	}
+	return snake->occupied.get(x, y);
+}
+
+/**
+ * Play on a Level, giving the Snake a mapping of the Level's cells
+ * to mark its body in. Must be called before the Snake first grows.
+ * @param level The Level to play on, which must outlive the Game.
+ */
+void Game::set_level(Level* level) {
+	this->level = level;
+	cells = level->map_cells();
+	snake->cells = cells;
+	snake->cells_width = level->width;
+}
+
+/**
+ * Place a new treasure on a random cell not occupied by the Snake
+ * or a wall.
+ */
+void Game::place_treasure() {
+	bool generate_treasure = true;
+	while (generate_treasure) {
+		treasure = get_random_point();
+		generate_treasure = is_blocked(treasure.x, treasure.y);
+	}
+}
+
+/**
+ * Get a random Point within the bounds of the board.
+ * @return a random Point within the bounds of the board.
+ */
+Point Game::get_random_point() {
+	int x = width_dist(random_engine);
+	int y = height_dist(random_engine);
+	return Point(x, y);
+}
@@ -0,0 +1,167 @@
+/*
+ * Game.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <cstdint>
+#include <random>
+#include <stdbool.h>
+#include "Point.h"
+#include "Snake.h"
+#include "Level.h"
+
+/**
+ * Used to define the game's difficulty setting.
+ */
+enum class Difficulty {
+	EASY, NORMAL, HARD
+};
+
+/**
+ * Describes what happened during a single call to Game::tick().
+ */
+enum class TickResult {
+	PAUSED, MOVED, ATE, GAME_OVER, VICTORY
+};
+
+/**
+ * Get the number of microseconds between ticks for a Snake heading in
+ * the given Direction. Vertical moves are slower, since terminal cells
+ * are taller than they are wide, unless sync_frame_rate is set.
+ * @param difficulty The difficulty setting.
+ * @param sync_frame_rate true to use the vertical rate for both axes.
+ * @param direction The Direction the Snake is heading.
+ * @return The delay before the next tick, in microseconds.
+ */
+long tick_interval(Difficulty difficulty, bool sync_frame_rate, Direction direction);
+
+/**
+ * Holds the complete state of a single game session.
+ *
+ * A Game never blocks, sleeps or reads the terminal itself: the caller
+ * feeds it input with turn() and toggle_pause() and advances it with
+ * tick() once tick_interval() microseconds have passed. This lets one
+ * thread drive any number of sessions, see Scheduler.
+ */
+struct Game {
+	int width = 0;
+	int height = 0;
+	Difficulty difficulty = Difficulty::NORMAL;
+	bool sync_frame_rate = false;
+	Snake* snake = nullptr;
+	Point treasure;
+	bool quit = false;
+
+	/**
+	 * The walls of the board, or nullptr for an empty rectangle.
+	 * Not owned by the Game.
+	 */
+	Level* level = nullptr;
+
+	/**
+	 * The Game's own mapping of the level's cells, see
+	 * Level::map_cells(), in which the Snake marks its body with
+	 * LEVEL_CELL_BODY so that is_blocked() is a single lookup. Only the
+	 * pages the Snake has touched are copied. nullptr without a level,
+	 * or if the cells could not be mapped, in which case the Snake
+	 * tracks its body in its Grid as usual.
+	 */
+	uint8_t* cells = nullptr;
+
+	/**
+	 * The cell vacated by the Snake's tail during the last tick,
+	 * only meaningful when that tick returned TickResult::MOVED.
+	 */
+	Point vacated;
+
+	/**
+	 * Variables used for RNG.
+	 */
+	std::default_random_engine random_engine;
+	std::uniform_int_distribution<int> width_dist;
+	std::uniform_int_distribution<int> height_dist;
+
+	/**
+	 * Create a new Game with the Snake centered on the board
+	 * and the first treasure already placed.
+	 * @param width The width of the board.
+	 * @param height The height of the board.
+	 * @param seed The seed to use for RNG.
+	 */
+	Game(int width, int height, unsigned int seed);
+
+	/**
+	 * Create a new Game on a Level, with the Snake on the Level's start
+	 * cell and the first treasure already placed.
+	 * @param level The Level to play on, which must outlive the Game.
+	 * @param seed The seed to use for RNG.
+	 */
+	Game(Level* level, unsigned int seed);
+
+	/**
+	 * Create an empty Game, to be filled in by decode_snapshot().
+	 */
+	Game() {}
+	Game(const Game&) = delete;
+	Game& operator=(const Game&) = delete;
+	~Game();
+
+	/**
+	 * Get the number of microseconds to wait before the next tick,
+	 * based on the difficulty and the Snake's current Direction.
+	 * @return The delay before the next tick, in microseconds.
+	 */
+	long tick_interval();
+
+	/**
+	 * Turn the Snake and unpause the Game, unless the Snake is already
+	 * heading along the same axis.
+	 * @param direction The Direction to turn to.
+	 */
+	void turn(Direction direction);
+
+	/**
+	 * Pause the Game, or unpause it if paused.
+	 */
+	void toggle_pause();
+
+	/**
+	 * Advance the Game by one frame.
+	 * @return What happened during this frame.
+	 */
+	TickResult tick();
+
+	/**
+	 * Check whether moving onto a cell would end the game.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 * @return true if the cell is off the board, a wall, or covered by the Snake.
+	 */
+	bool is_blocked(int x, int y);
+
+	/**
+	 * Play on a Level, giving the Snake a mapping of the Level's cells
+	 * to mark its body in. Must be called before the Snake first grows.
+	 * @param level The Level to play on, which must outlive the Game.
+	 */
+	void set_level(Level* level);
+
+	/**
+	 * Place a new treasure on a random cell not occupied by the Snake
+	 * or a wall.
+	 */
+	void place_treasure();
+
+	/**
+	 * Get a random Point within the bounds of the board.
+	 * @return a random Point within the bounds of the board.
+	 */
+	Point get_random_point();
+};
+
+#endif /* GAME_H_ */
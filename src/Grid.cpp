@@ -0,0 +1,128 @@
+/*
+ * Grid.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include "Grid.h"
+
+/**
+ * Get the key of the Chunk containing a cell.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ * @return The key of the Chunk in Grid::chunks.
+ */
+static uint64_t chunk_key(int x, int y) {
+	uint32_t cx = (uint32_t) (x >> GRID_CHUNK_BITS);
+	uint32_t cy = (uint32_t) (y >> GRID_CHUNK_BITS);
+	return ((uint64_t) cx << 32) | cy;
+}
+
+Grid::~Grid() {
+	for (auto& entry : chunks) {
+		delete entry.second;
+	}
+}
+
+/**
+ * Create a deep copy of another Grid, with its own Chunks.
+ * @param other The Grid to copy.
+ */
+Grid::Grid(const Grid& other) {
+	chunks.reserve(other.chunks.size());
+	for (auto& entry : other.chunks) {
+		chunks[entry.first] = new Chunk(*entry.second);
+	}
+}
+
+/**
+ * Replace this Grid's cells with a deep copy of another Grid's.
+ * @param other The Grid to copy.
+ * @return This Grid.
+ */
+Grid& Grid::operator=(const Grid& other) {
+	if (this != &other) {
+		for (auto& entry : chunks) {
+			delete entry.second;
+		}
+		chunks.clear();
+		last_chunk = nullptr;
+		chunks.reserve(other.chunks.size());
+		for (auto& entry : other.chunks) {
+			chunks[entry.first] = new Chunk(*entry.second);
+		}
+	}
+	return *this;
+}
+
+/**
+ * Check whether a cell is occupied.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ * @return true if the cell is occupied, else false.
+ */
+bool Grid::get(int x, int y) const {
+	auto it = chunks.find(chunk_key(x, y));
+	if (it == chunks.end()) {
+		return false;
+	}
+	return (it->second->rows[y & GRID_CHUNK_MASK] >> (x & GRID_CHUNK_MASK)) & 1;
+}
+
+/**
+ * Mark a cell as occupied.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ * @return true if the cell was free before, else false.
+ */
+bool Grid::set(int x, int y) {
+	uint64_t key = chunk_key(x, y);
+	if (last_chunk == nullptr || key != last_key) {
+		Chunk*& chunk = chunks[key];
+		if (chunk == nullptr) {
+			chunk = new Chunk();
+		}
+		last_key = key;
+		last_chunk = chunk;
+	}
+	Chunk* chunk = last_chunk;
+	uint64_t bit = (uint64_t) 1 << (x & GRID_CHUNK_MASK);
+	uint64_t& row = chunk->rows[y & GRID_CHUNK_MASK];
+	if (row & bit) {
+		return false;
+	}
+	row |= bit;
+	chunk->count++;
+	return true;
+}
+
+/**
+ * Mark a cell as free, releasing its Chunk once the Chunk is empty.
+ * @param x The x coordinate of the cell.
+ * @param y The y coordinate of the cell.
+ */
+void Grid::clear(int x, int y) {
+	uint64_t key = chunk_key(x, y);
+	Chunk* chunk = last_chunk;
+	if (chunk == nullptr || key != last_key) {
+		auto it = chunks.find(key);
+		if (it == chunks.end()) {
+			return;
+		}
+		chunk = it->second;
+	}
+	uint64_t bit = (uint64_t) 1 << (x & GRID_CHUNK_MASK);
+	uint64_t& row = chunk->rows[y & GRID_CHUNK_MASK];
+	if (row & bit) {
+		row &= ~bit;
+		chunk->count--;
+		if (chunk->count == 0) {
+			if (chunk == last_chunk) {
+				last_chunk = nullptr;
+			}
+			delete chunk;
+			chunks.erase(key);
+		}
+	}
+}
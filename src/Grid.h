@@ -0,0 +1,86 @@
+/*
+ * Grid.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef GRID_H_
+#define GRID_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <stdbool.h>
+
+/**
+ * Each Chunk covers a square of (1 << GRID_CHUNK_BITS) cells per side.
+ */
+#define GRID_CHUNK_BITS 6
+#define GRID_CHUNK_SIZE (1 << GRID_CHUNK_BITS)
+#define GRID_CHUNK_MASK (GRID_CHUNK_SIZE - 1)
+
+/**
+ * A square block of occupancy bits, one 64-bit row per y.
+ */
+struct Chunk {
+	uint64_t rows[GRID_CHUNK_SIZE] = { };
+	int count = 0;
+};
+
+/**
+ * A sparse set of occupied cells on an arbitrarily large board.
+ *
+ * Cells are grouped into Chunks which are only allocated while at least
+ * one of their cells is set, so memory follows the number of occupied
+ * cells rather than the board area. Every operation is O(1).
+ *
+ * set() and clear() remember the last Chunk they touched, since a Snake
+ * writes runs of neighbouring cells. get() never uses it, so any number
+ * of threads may call get() while no thread writes.
+ */
+struct Grid {
+	std::unordered_map<uint64_t, Chunk*> chunks;
+	uint64_t last_key = 0;
+	Chunk* last_chunk = nullptr;
+
+	Grid() {}
+	~Grid();
+
+	/**
+	 * Create a deep copy of another Grid, with its own Chunks.
+	 * @param other The Grid to copy.
+	 */
+	Grid(const Grid& other);
+
+	/**
+	 * Replace this Grid's cells with a deep copy of another Grid's.
+	 * @param other The Grid to copy.
+	 * @return This Grid.
+	 */
+	Grid& operator=(const Grid& other);
+
+	/**
+	 * Check whether a cell is occupied.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 * @return true if the cell is occupied, else false.
+	 */
+	bool get(int x, int y) const;
+
+	/**
+	 * Mark a cell as occupied.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 * @return true if the cell was free before, else false.
+	 */
+	bool set(int x, int y);
+
+	/**
+	 * Mark a cell as free, releasing its Chunk once the Chunk is empty.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 */
+	void clear(int x, int y);
+};
+
+#endif /* GRID_H_ */
@@ -0,0 +1,125 @@
+/*
+ * History.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include "History.h"
+
+/**
+ * Create a History retaining at most capacity ticks.
+ * @param capacity The number of ticks to retain, 0 to disable.
+ */
+History::History(int capacity) :
+		ring(capacity) {
+}
+
+/**
+ * Record the tick the Game just made. Any ticks that had been
+ * rewound past are discarded.
+ * @param game The Game, after calling tick().
+ * @param result The value returned by tick().
+ */
+void History::record(Game* game, TickResult result) {
+	if (ring.empty() || (result != TickResult::MOVED && result != TickResult::ATE)) {
+		return;
+	}
+	Snake* snake = game->snake;
+
+	TickDelta delta;
+	delta.head_x = snake->head().x;
+	delta.head_y = snake->head().y;
+	if (result == TickResult::MOVED) {
+		delta.tail_x = game->vacated.x;
+		delta.tail_y = game->vacated.y;
+		delta.old_treasure_x = game->treasure.x;
+		delta.old_treasure_y = game->treasure.y;
+	} else {
+		delta.tail_x = -1;
+		delta.tail_y = -1;
+		delta.old_treasure_x = delta.head_x;
+		delta.old_treasure_y = delta.head_y;
+	}
+	delta.new_treasure_x = game->treasure.x;
+	delta.new_treasure_y = game->treasure.y;
+	delta.direction = (uint8_t) snake->direction;
+
+	long capacity = ring.size();
+	last = cursor;
+	ring[last % capacity] = delta;
+	last++;
+	cursor = last;
+	if (last - first > capacity) {
+		first = last - capacity;
+	}
+}
+
+/**
+ * Undo the most recent tick applied to the Game.
+ * @param game The Game to rewind.
+ * @param delta Set to the delta that was undone.
+ * @return false if there is no retained tick to undo.
+ */
+bool History::rewind(Game* game, TickDelta* delta) {
+	if (cursor <= first) {
+		return false;
+	}
+	cursor--;
+	*delta = ring[cursor % ring.size()];
+	Snake* snake = game->snake;
+
+	// restore the tail before dropping the head, so the Snake
+	// never shrinks below one cell
+	if (!delta->grew()) {
+		snake->push_tail(Point(delta->tail_x, delta->tail_y));
+	}
+	snake->pop_head();
+
+	if (delta->old_treasure_x != delta->new_treasure_x
+	        || delta->old_treasure_y != delta->new_treasure_y) {
+		game->treasure = Point(delta->old_treasure_x, delta->old_treasure_y);
+	}
+	snake->direction = (Direction) delta->direction;
+	snake->game_over = false;
+	return true;
+}
+
+/**
+ * Redo the tick following the cursor, after a rewind().
+ * @param game The Game to fast-forward.
+ * @param delta Set to the delta that was redone.
+ * @return false if the cursor is at the newest recorded tick.
+ */
+bool History::forward(Game* game, TickDelta* delta) {
+	if (cursor >= last) {
+		return false;
+	}
+	*delta = ring[cursor % ring.size()];
+	cursor++;
+	Snake* snake = game->snake;
+
+	Point head(delta->head_x, delta->head_y);
+	if (delta->grew()) {
+		snake->grow(head);
+		game->treasure = Point(delta->new_treasure_x, delta->new_treasure_y);
+	} else {
+		snake->move(head);
+	}
+	snake->direction = (Direction) delta->direction;
+	return true;
+}
+
+/**
+ * Rewind or fast-forward the Game to just before the given tick,
+ * clamped to the retained range.
+ * @param game The Game to move through time.
+ * @param tick The tick to move the cursor to.
+ */
+void History::seek(Game* game, long tick) {
+	TickDelta delta;
+	while (cursor > tick && rewind(game, &delta)) {
+	}
+	while (cursor < tick && forward(game, &delta)) {
+	}
+}
@@ -0,0 +1,99 @@
+/*
+ * History.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include <cstdint>
+#include <vector>
+#include <stdbool.h>
+#include "Game.h"
+
+/**
+ * The most ticks a History may retain, about 36 MB of TickDeltas.
+ */
+#define HISTORY_MAX_TICKS 1000000
+
+/**
+ * Everything a single tick changed. A tick always adds a head, and
+ * either vacates a tail cell or (when the treasure was eaten) moves
+ * the treasure, so a fixed-size record is enough to undo or redo it.
+ */
+struct TickDelta {
+	int32_t head_x;
+	int32_t head_y;
+	int32_t tail_x;       // -1 if the Snake grew instead of moving
+	int32_t tail_y;
+	int32_t old_treasure_x;
+	int32_t old_treasure_y;
+	int32_t new_treasure_x;
+	int32_t new_treasure_y;
+	uint8_t direction;    // the Direction the Snake moved in
+
+	/**
+	 * Check whether this tick made the Snake grow.
+	 * @return true if the treasure was eaten during this tick.
+	 */
+	bool grew() {
+		return tail_x < 0;
+	}
+};
+
+/**
+ * A bounded ring of TickDeltas that lets a Game step backwards and
+ * forwards through its most recent ticks.
+ *
+ * Ticks are numbered from 0 in the order they were recorded. Only the
+ * last `capacity` of them are retained; stepping between two retained
+ * ticks costs one delta per tick of distance.
+ */
+struct History {
+	std::vector<TickDelta> ring;
+	long first = 0;   // oldest retained tick
+	long last = 0;    // one past the newest recorded tick
+	long cursor = 0;  // the Game reflects all ticks before this one
+
+	/**
+	 * Create a History retaining at most capacity ticks.
+	 * @param capacity The number of ticks to retain, 0 to disable.
+	 */
+	History(int capacity);
+
+	/**
+	 * Record the tick the Game just made. Any ticks that had been
+	 * rewound past are discarded.
+	 * @param game The Game, after calling tick().
+	 * @param result The value returned by tick().
+	 */
+	void record(Game* game, TickResult result);
+
+	/**
+	 * Undo the most recent tick applied to the Game.
+	 * @param game The Game to rewind.
+	 * @param delta Set to the delta that was undone.
+	 * @return false if there is no retained tick to undo.
+	 */
+	bool rewind(Game* game, TickDelta* delta);
+
+	/**
+	 * Redo the tick following the cursor, after a rewind().
+	 * @param game The Game to fast-forward.
+	 * @param delta Set to the delta that was redone.
+	 * @return false if the cursor is at the newest recorded tick.
+	 */
+	bool forward(Game* game, TickDelta* delta);
+
+	/**
+	 * Rewind or fast-forward the Game to just before the given tick,
+	 * clamped to the retained range.
+	 * @param game The Game to move through time.
+	 * @param tick The tick to move the cursor to.
+	 */
+	void seek(Game* game, long tick);
+};
+
+#endif /* HISTORY_H_ */
@@ -0,0 +1,277 @@
+/*
+ * Leaderboard.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Leaderboard.h"
+
+/**
+ * Compute the CRC-32 (IEEE) of a block of memory.
+ * @param data The bytes to checksum.
+ * @param size The number of bytes.
+ * @return The CRC-32 of the bytes.
+ */
+static uint32_t crc32(const void* data, size_t size) {
+	static uint32_t table[256];
+	static bool initialized = false;
+	if (!initialized) {
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+			}
+			table[i] = c;
+		}
+		initialized = true;
+	}
+	const uint8_t* bytes = (const uint8_t*) data;
+	uint32_t crc = 0xffffffff;
+	for (size_t i = 0; i < size; i++) {
+		crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffff;
+}
+
+/**
+ * Check whether a record from the log is complete and uncorrupted.
+ * @param record The record to check.
+ * @return true if the record can be trusted.
+ */
+static bool valid_record(const ScoreRecord& record) {
+	return record.magic == SCORE_RECORD_MAGIC
+	        && record.difficulty <= (uint8_t) Difficulty::HARD
+	        && record.crc == crc32(&record, offsetof(ScoreRecord, crc));
+}
+
+/**
+ * Get the checksum of an index, covering every byte after the field.
+ * @param index The index to checksum.
+ * @return The checksum.
+ */
+static uint32_t index_checksum(const ScoreIndex* index) {
+	size_t begin = offsetof(ScoreIndex, top_k);
+	return crc32((const char*) index + begin, sizeof(ScoreIndex) - begin);
+}
+
+/**
+ * Insert a record into the top scores of its Difficulty, keeping them
+ * sorted best first. Earlier games win ties.
+ * @param index The index to update.
+ * @param record The record to insert.
+ */
+static void insert_top(ScoreIndex* index, const ScoreRecord& record) {
+	int d = record.difficulty;
+	int count = index->games[d] < LEADERBOARD_TOP_K ? index->games[d] : LEADERBOARD_TOP_K;
+	index->games[d]++;
+
+	ScoreRecord* top = index->top[d];
+	int i = count;
+	while (i > 0 && (top[i - 1].score < record.score
+	        || (top[i - 1].score == record.score && top[i - 1].timestamp > record.timestamp))) {
+		if (i < LEADERBOARD_TOP_K) {
+			top[i] = top[i - 1];
+		}
+		i--;
+	}
+	if (i < LEADERBOARD_TOP_K) {
+		top[i] = record;
+	}
+}
+
+/**
+ * Use the leaderboard stored in a directory, creating it if needed.
+ * @param dir The directory holding the score log and index.
+ */
+Leaderboard::Leaderboard(const std::string& dir) {
+	mkdir(dir.c_str(), 0755);
+	log_path = dir + "/scores.log";
+	index_path = dir + "/scores.idx";
+}
+
+/**
+ * Append a finished game to the log and update the index.
+ * @param record The game to record.
+ * @return true if the game was appended to the log.
+ */
+bool Leaderboard::record(ScoreRecord record) {
+	int fd = open(log_path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	// a single write of a small record to an O_APPEND file is placed
+	// atomically at the end, even with other processes appending
+	bool ok = write(fd, &record, sizeof(record)) == (ssize_t) sizeof(record);
+	ok = fsync(fd) == 0 && ok;
+	close(fd);
+	if (ok) {
+		update_index();
+	}
+	return ok;
+}
+
+/**
+ * Bring the index up to date with the log.
+ * @return true if the index could be opened and updated.
+ */
+bool Leaderboard::update_index() {
+	int fd = open(index_path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	if (flock(fd, LOCK_EX) != 0 || ftruncate(fd, sizeof(ScoreIndex)) != 0) {
+		close(fd);
+		return false;
+	}
+	void* map = mmap(nullptr, sizeof(ScoreIndex), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+	ScoreIndex* index = (ScoreIndex*) map;
+
+	int log_fd = open(log_path.c_str(), O_RDONLY);
+	struct stat st;
+	uint64_t log_size = 0;
+	if (log_fd >= 0 && fstat(log_fd, &st) == 0) {
+		log_size = st.st_size;
+	}
+
+	// start over from the beginning of the log if the index is new,
+	// was torn by a crash, or no longer matches the log
+	if (index->magic != SCORE_INDEX_MAGIC || index->version != SCORE_INDEX_VERSION
+	        || index->top_k != LEADERBOARD_TOP_K || index->checksum != index_checksum(index)
+	        || index->log_offset > log_size) {
+		memset(index, 0, sizeof(ScoreIndex));
+		index->magic = SCORE_INDEX_MAGIC;
+		index->version = SCORE_INDEX_VERSION;
+		index->top_k = LEADERBOARD_TOP_K;
+	}
+
+	// index the new records, stepping over damaged bytes one at a time
+	// until a valid record lines up again
+	if (log_fd >= 0 && index->log_offset < log_size) {
+		std::vector<char> buffer(log_size - index->log_offset);
+		ssize_t length = pread(log_fd, buffer.data(), buffer.size(), index->log_offset);
+		size_t pos = 0;
+		while (length > 0 && pos + sizeof(ScoreRecord) <= (size_t) length) {
+			ScoreRecord record;
+			memcpy(&record, &buffer[pos], sizeof(record));
+			if (valid_record(record)) {
+				insert_top(index, record);
+				pos += sizeof(record);
+			} else {
+				pos++;
+			}
+		}
+		index->log_offset += pos;
+	}
+	index->checksum = index_checksum(index);
+
+	if (log_fd >= 0) {
+		close(log_fd);
+	}
+	munmap(map, sizeof(ScoreIndex));
+	close(fd);
+	return true;
+}
+
+/**
+ * Copy the best games for a Difficulty out of an index file, if it
+ * passes every check update_index() makes.
+ * @param index_path The index file.
+ * @param difficulty The Difficulty to look up.
+ * @param games Set to the number of games recorded at this Difficulty.
+ * @param result Set to up to LEADERBOARD_TOP_K games, best first.
+ * @return true if the index was valid.
+ */
+static bool read_top(const std::string& index_path, Difficulty difficulty, uint64_t* games,
+        std::vector<ScoreRecord>* result) {
+	int fd = open(index_path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (flock(fd, LOCK_SH) != 0 || fstat(fd, &st) != 0
+	        || (size_t) st.st_size < sizeof(ScoreIndex)) {
+		close(fd);
+		return false;
+	}
+	void* map = mmap(nullptr, sizeof(ScoreIndex), PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+	const ScoreIndex* index = (const ScoreIndex*) map;
+	bool valid = index->magic == SCORE_INDEX_MAGIC && index->version == SCORE_INDEX_VERSION
+	        && index->top_k == LEADERBOARD_TOP_K && index->checksum == index_checksum(index);
+	if (valid) {
+		int d = (int) difficulty;
+		*games = index->games[d];
+		uint64_t count = *games < LEADERBOARD_TOP_K ? *games : LEADERBOARD_TOP_K;
+		result->assign(index->top[d], index->top[d] + count);
+	}
+	munmap(map, sizeof(ScoreIndex));
+	close(fd);
+	return valid;
+}
+
+/**
+ * Get the best recorded games for a Difficulty. An index that is
+ * missing or fails its checksum is rebuilt from the log first.
+ * @param difficulty The Difficulty to look up.
+ * @param games Set to the number of games recorded at this Difficulty.
+ * @return Up to LEADERBOARD_TOP_K games, best first.
+ */
+std::vector<ScoreRecord> Leaderboard::top(Difficulty difficulty, uint64_t* games) {
+	std::vector<ScoreRecord> result;
+	*games = 0;
+	if (!read_top(index_path, difficulty, games, &result) && update_index()) {
+		read_top(index_path, difficulty, games, &result);
+	}
+	return result;
+}
+
+/**
+ * Describe a finished Game as a ScoreRecord.
+ * @param game The Game that ended.
+ * @param duration_ms How long the Game was played, in milliseconds.
+ * @return The ScoreRecord, with its crc filled in.
+ */
+ScoreRecord make_score_record(Game* game, long duration_ms) {
+	ScoreRecord record;
+	memset(&record, 0, sizeof(record));
+	record.magic = SCORE_RECORD_MAGIC;
+	record.difficulty = (uint8_t) game->difficulty;
+	record.score = game->snake->segment_count;
+	record.width = game->width;
+	record.height = game->height;
+	record.duration_ms = duration_ms;
+	record.timestamp = time(0);
+	record.crc = crc32(&record, offsetof(ScoreRecord, crc));
+	return record;
+}
+
+/**
+ * Get the default leaderboard directory, "~/.snakegame".
+ * @return The directory, or an empty string if $HOME is not set.
+ */
+std::string default_leaderboard_dir() {
+	const char* home = getenv("HOME");
+	if (home == nullptr || home[0] == '\0') {
+		return "";
+	}
+	return std::string(home) + "/.snakegame";
+}
@@ -0,0 +1,118 @@
+/*
+ * Leaderboard.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef LEADERBOARD_H_
+#define LEADERBOARD_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdbool.h>
+#include "Game.h"
+
+/**
+ * Identifies score records and the top scores index, and the layout
+ * version they were written with.
+ */
+#define SCORE_RECORD_MAGIC 0x52534e53 // "SNSR"
+#define SCORE_INDEX_MAGIC  0x49534e53 // "SNSI"
+#define SCORE_INDEX_VERSION 1
+
+/**
+ * The number of top scores kept per Difficulty.
+ */
+#define LEADERBOARD_TOP_K 10
+
+/**
+ * One finished game, as appended to the score log. The crc covers every
+ * byte before it, so torn or corrupted records can be skipped.
+ */
+struct ScoreRecord {
+	uint32_t magic;
+	uint8_t difficulty;
+	uint8_t reserved[3];
+	int32_t score;
+	int32_t width;
+	int32_t height;
+	uint32_t duration_ms;
+	int64_t timestamp;    // seconds since the epoch
+	uint32_t crc;
+	uint32_t padding;
+};
+
+/**
+ * The top scores index, memory-mapped from its file. The checksum
+ * covers every byte after it; an index that fails it is rebuilt from
+ * the score log.
+ */
+struct ScoreIndex {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t checksum;
+	uint32_t top_k;
+	uint64_t log_offset;  // bytes of the score log already indexed
+	uint64_t games[3];    // games recorded per Difficulty
+	ScoreRecord top[3][LEADERBOARD_TOP_K];
+};
+
+/**
+ * A persistent leaderboard shared by every player on the host.
+ *
+ * Finished games are appended to a log with a single O_APPEND write
+ * each, so any number of processes can record scores without a lock.
+ * The top scores per Difficulty are kept in a separate memory-mapped
+ * index, which is brought up to date with the end of the log under a
+ * lock on the index file alone.
+ */
+struct Leaderboard {
+	std::string log_path;
+	std::string index_path;
+
+	/**
+	 * Use the leaderboard stored in a directory, creating it if needed.
+	 * @param dir The directory holding the score log and index.
+	 */
+	Leaderboard(const std::string& dir);
+
+	/**
+	 * Append a finished game to the log and update the index.
+	 * @param record The game to record.
+	 * @return true if the game was appended to the log.
+	 */
+	bool record(ScoreRecord record);
+
+	/**
+	 * Get the best recorded games for a Difficulty. An index that is
+	 * missing or fails its checksum is rebuilt from the log first.
+	 * @param difficulty The Difficulty to look up.
+	 * @param games Set to the number of games recorded at this Difficulty.
+	 * @return Up to LEADERBOARD_TOP_K games, best first.
+	 */
+	std::vector<ScoreRecord> top(Difficulty difficulty, uint64_t* games);
+
+	/**
+	 * Bring the index up to date with the log.
+	 * @return true if the index could be opened and updated.
+	 */
+	bool update_index();
+};
+
+/**
+ * Describe a finished Game as a ScoreRecord.
+ * @param game The Game that ended.
+ * @param duration_ms How long the Game was played, in milliseconds.
+ * @return The ScoreRecord, with its crc filled in.
+ */
+ScoreRecord make_score_record(Game* game, long duration_ms);
+
+/**
+ * Get the default leaderboard directory, "~/.snakegame".
+ * @return The directory, or an empty string if $HOME is not set.
+ */
+std::string default_leaderboard_dir();
+
+#endif /* LEADERBOARD_H_ */
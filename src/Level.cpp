@@ -0,0 +1,277 @@
+/*
+ * Level.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Level.h"
+#include "Direction.h"
+
+Level::~Level() {
+	if (map != nullptr) {
+		munmap(map, map_size);
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+/**
+ * Map a private, writable copy of the level's cells, e.g. for a Game
+ * to mark its Snake in. Pages are only copied once written to, so
+ * this takes the same time for any size of level.
+ * @return The cells, laid out like cells, or nullptr on failure.
+ */
+uint8_t* Level::map_cells() const {
+	void* copy = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (copy == MAP_FAILED) {
+		return nullptr;
+	}
+	return (uint8_t*) copy + (cells - (const uint8_t*) map);
+}
+
+/**
+ * Unmap cells returned by map_cells().
+ * @param copy The cells to unmap.
+ */
+void Level::unmap_cells(uint8_t* copy) const {
+	munmap(copy - (cells - (const uint8_t*) map), map_size);
+}
+
+/**
+ * Compile a text level into the binary level format. In the text, '#'
+ * is a wall, 'S' is the Snake's starting cell, and anything else is
+ * open. Short lines are padded with open cells. Without an 'S', the
+ * Snake starts in the center, which must then be open. Open cells that
+ * can't be reached from the start are compiled as walls.
+ * @param text The text of the level.
+ * @param error Set to a description of the problem if compiling fails.
+ * @return The compiled level, or an empty string if compiling fails.
+ */
+std::string compile_level(const std::string& text, std::string* error) {
+	// split into lines, ignoring a trailing newline
+	std::vector<std::string> lines;
+	size_t begin = 0;
+	while (begin < text.length()) {
+		size_t end = text.find('\n', begin);
+		if (end == std::string::npos) {
+			end = text.length();
+		}
+		std::string line = text.substr(begin, end - begin);
+		if (line.length() > 0 && line.back() == '\r') {
+			line.pop_back();
+		}
+		lines.push_back(line);
+		begin = end + 1;
+	}
+
+	size_t width = 0;
+	for (std::string& line : lines) {
+		width = std::max(width, line.length());
+	}
+	size_t height = lines.size();
+	if (width == 0 || height == 0 || width > 100000 || height > 100000) {
+		*error = "The level must be between 1x1 and 100000x100000 cells.";
+		return "";
+	}
+	size_t count = width * height;
+
+	// mark walls and find the start
+	std::vector<uint8_t> cells(count, 0);
+	long start_x = -1;
+	long start_y = -1;
+	uint64_t open_cells = 0;
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			char c = x < lines[y].length() ? lines[y][x] : ' ';
+			if (c == '#') {
+				cells[y * width + x] = LEVEL_CELL_WALL;
+				continue;
+			}
+			open_cells++;
+			if (c == 'S') {
+				if (start_x >= 0) {
+					*error = "The level has more than one start 'S'.";
+					return "";
+				}
+				start_x = x;
+				start_y = y;
+			}
+		}
+	}
+	if (start_x < 0) {
+		start_x = width / 2;
+		start_y = height / 2;
+		if (cells[start_y * width + start_x] & LEVEL_CELL_WALL) {
+			*error = "The center of the level is a wall, so it needs a start 'S'.";
+			return "";
+		}
+	}
+
+	// open cells the Snake can't reach from the start become walls,
+	// so no treasure is ever placed out of reach
+	std::vector<bool> reached(count, false);
+	std::vector<size_t> stack;
+	reached[start_y * width + start_x] = true;
+	stack.push_back(start_y * width + start_x);
+	while (!stack.empty()) {
+		size_t i = stack.back();
+		stack.pop_back();
+		size_t x = i % width;
+		size_t y = i / width;
+		for (int d = 0; d < 4; d++) {
+			long nx = x + DIRECTION_DX[d];
+			long ny = y + DIRECTION_DY[d];
+			if (nx < 0 || nx >= (long) width || ny < 0 || ny >= (long) height) {
+				continue;
+			}
+			size_t n = ny * width + nx;
+			if (!reached[n] && !(cells[n] & LEVEL_CELL_WALL)) {
+				reached[n] = true;
+				stack.push_back(n);
+			}
+		}
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!reached[i] && !(cells[i] & LEVEL_CELL_WALL)) {
+			cells[i] = LEVEL_CELL_WALL;
+			open_cells--;
+		}
+	}
+
+	// connectivity, and the first ring of the distance field: open
+	// cells next to a wall or the edge of the board
+	std::vector<uint16_t> distances(count, LEVEL_MAX_DISTANCE);
+	std::vector<size_t> frontier;
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			size_t i = y * width + x;
+			if (cells[i] & LEVEL_CELL_WALL) {
+				distances[i] = 0;
+				continue;
+			}
+			bool edge = false;
+			for (int d = 0; d < 4; d++) {
+				long nx = x + DIRECTION_DX[d];
+				long ny = y + DIRECTION_DY[d];
+				if (nx < 0 || nx >= (long) width || ny < 0 || ny >= (long) height
+				        || (cells[ny * width + nx] & LEVEL_CELL_WALL)) {
+					edge = true;
+				} else {
+					cells[i] |= 1 << d;
+				}
+			}
+			if (edge) {
+				distances[i] = 1;
+				frontier.push_back(i);
+			}
+		}
+	}
+
+	// breadth-first search inwards from the first ring
+	for (uint16_t distance = 2; !frontier.empty(); distance++) {
+		std::vector<size_t> next;
+		for (size_t i : frontier) {
+			size_t x = i % width;
+			size_t y = i / width;
+			for (int d = 0; d < 4; d++) {
+				if (!(cells[i] & (1 << d))) {
+					continue;
+				}
+				size_t n = (y + DIRECTION_DY[d]) * width + (x + DIRECTION_DX[d]);
+				if (distances[n] == LEVEL_MAX_DISTANCE) {
+					distances[n] = distance;
+					next.push_back(n);
+				}
+			}
+		}
+		frontier.swap(next);
+		if (distance == LEVEL_MAX_DISTANCE) {
+			break;
+		}
+	}
+
+	LevelHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = LEVEL_MAGIC;
+	header.version = LEVEL_VERSION;
+	header.width = width;
+	header.height = height;
+	header.start_x = start_x;
+	header.start_y = start_y;
+	header.open_cells = open_cells;
+	header.checksum = 0xcbf29ce484222325;
+	for (size_t i = 0; i < count; i++) {
+		header.checksum = (header.checksum ^ cells[i]) * 0x100000001b3;
+	}
+
+	std::string data(sizeof(header) + count * sizeof(uint16_t) + count, '\0');
+	memcpy(&data[0], &header, sizeof(header));
+	memcpy(&data[sizeof(header)], distances.data(), count * sizeof(uint16_t));
+	memcpy(&data[sizeof(header) + count * sizeof(uint16_t)], cells.data(), count);
+	return data;
+}
+
+/**
+ * Map a compiled level file into memory. Only the header and the start
+ * cell are checked, so this takes the same time for any size of level.
+ * @param path The compiled level file.
+ * @return The Level, or nullptr if the file is not a valid level.
+ */
+Level* load_level(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(LevelHeader)) {
+		close(fd);
+		return nullptr;
+	}
+	void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		return nullptr;
+	}
+
+	// the file stays open for map_cells()
+	Level* level = new Level();
+	level->fd = fd;
+	level->map = map;
+	level->map_size = st.st_size;
+
+	const LevelHeader* header = (const LevelHeader*) map;
+	size_t count = (size_t) header->width * header->height;
+	if (header->magic != LEVEL_MAGIC || header->version != LEVEL_VERSION
+	        || header->width <= 0 || header->height <= 0
+	        || level->map_size != sizeof(LevelHeader) + count * sizeof(uint16_t) + count
+	        || header->start_x < 0 || header->start_x >= header->width
+	        || header->start_y < 0 || header->start_y >= header->height
+	        || header->open_cells == 0) {
+		delete level;
+		return nullptr;
+	}
+	level->width = header->width;
+	level->height = header->height;
+	level->start_x = header->start_x;
+	level->start_y = header->start_y;
+	level->open_cells = header->open_cells;
+	level->checksum = header->checksum;
+	level->distances = (const uint16_t*) ((const char*) map + sizeof(LevelHeader));
+	level->cells = (const uint8_t*) (level->distances + count);
+	if (level->wall(level->start_x, level->start_y)) {
+		delete level;
+		return nullptr;
+	}
+	return level;
+}
@@ -0,0 +1,146 @@
+/*
+ * Level.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef LEVEL_H_
+#define LEVEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdbool.h>
+
+/**
+ * Identifies a compiled level file, and the layout version it was written with.
+ */
+#define LEVEL_MAGIC   0x4c4b4e53 // "SNKL"
+#define LEVEL_VERSION 2
+
+/**
+ * Bits of a compiled level cell. The low four bits are set for each
+ * Direction in which the neighboring cell is open, indexed by the
+ * Direction's underlying value. LEVEL_CELL_BODY is never set in a level
+ * file: a Game sets it under the Snake in its own mapping of the cells,
+ * see Level::map_cells().
+ */
+#define LEVEL_CELL_WALL 0x80
+#define LEVEL_CELL_BODY 0x40
+#define LEVEL_CELL_NEIGHBORS 0x0f
+
+/**
+ * The largest distance stored in a level's distance field.
+ */
+#define LEVEL_MAX_DISTANCE 0xffff
+
+/**
+ * Fixed-size header at the start of every compiled level.
+ *
+ * It is followed by width * height uint16_t distances from each cell to
+ * the nearest wall or board edge (0 for walls), then by width * height
+ * cell bytes. Both are stored row by row, in native byte order. The
+ * checksum is the 64-bit FNV-1a hash of the cell bytes, identifying the
+ * level's layout without reading them.
+ */
+struct LevelHeader {
+	uint32_t magic;
+	uint32_t version;
+	int32_t width;
+	int32_t height;
+	int32_t start_x;
+	int32_t start_y;
+	uint64_t open_cells;
+	uint64_t checksum;
+};
+
+/**
+ * A compiled level, mapped read-only into memory.
+ */
+struct Level {
+	int width = 0;
+	int height = 0;
+	int start_x = 0;
+	int start_y = 0;
+	long long open_cells = 0;
+	uint64_t checksum = 0;
+
+	int fd = -1;
+	void* map = nullptr;
+	size_t map_size = 0;
+	const uint16_t* distances = nullptr;
+	const uint8_t* cells = nullptr;
+
+	Level() {}
+	Level(const Level&) = delete;
+	Level& operator=(const Level&) = delete;
+	~Level();
+
+	/**
+	 * Check whether a cell is a wall. Cells off the board count as walls.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 * @return true if the cell cannot be entered.
+	 */
+	bool wall(int x, int y) const {
+		return (unsigned) x >= (unsigned) width || (unsigned) y >= (unsigned) height
+		        || (cells[(size_t) y * width + x] & LEVEL_CELL_WALL);
+	}
+
+	/**
+	 * Get the number of moves from a cell to the nearest wall or edge.
+	 * @param x The x coordinate of the cell, on the board.
+	 * @param y The y coordinate of the cell, on the board.
+	 * @return The distance, 0 for walls.
+	 */
+	int distance(int x, int y) const {
+		return distances[(size_t) y * width + x];
+	}
+
+	/**
+	 * Get the open neighbors of a cell.
+	 * @param x The x coordinate of the cell, on the board.
+	 * @param y The y coordinate of the cell, on the board.
+	 * @return A bit per open neighbor, see LEVEL_CELL_NEIGHBORS.
+	 */
+	int neighbors(int x, int y) const {
+		return cells[(size_t) y * width + x] & LEVEL_CELL_NEIGHBORS;
+	}
+
+	/**
+	 * Map a private, writable copy of the level's cells, e.g. for a Game
+	 * to mark its Snake in. Pages are only copied once written to, so
+	 * this takes the same time for any size of level.
+	 * @return The cells, laid out like cells, or nullptr on failure.
+	 */
+	uint8_t* map_cells() const;
+
+	/**
+	 * Unmap cells returned by map_cells().
+	 * @param copy The cells to unmap.
+	 */
+	void unmap_cells(uint8_t* copy) const;
+};
+
+/**
+ * Compile a text level into the binary level format. In the text, '#'
+ * is a wall, 'S' is the Snake's starting cell, and anything else is
+ * open. Short lines are padded with open cells. Without an 'S', the
+ * Snake starts in the center, which must then be open. Open cells that
+ * can't be reached from the start are compiled as walls.
+ * @param text The text of the level.
+ * @param error Set to a description of the problem if compiling fails.
+ * @return The compiled level, or an empty string if compiling fails.
+ */
+std::string compile_level(const std::string& text, std::string* error);
+
+/**
+ * Map a compiled level file into memory. Only the header and the start
+ * cell are checked, so this takes the same time for any size of level.
+ * @param path The compiled level file.
+ * @return The Level, or nullptr if the file is not a valid level.
+ */
+Level* load_level(const std::string& path);
+
+#endif /* LEVEL_H_ */
@@ -0,0 +1,373 @@
+/*
+ * Recorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef SNAKEGAME_ZSTD
+#include <zstd.h>
+#endif
+
+#include "Recorder.h"
+
+/**
+ * Get the current time of the monotonic clock.
+ * @return The current time, in microseconds.
+ */
+static int64_t now_us() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Append text to a JSON string, escaping it.
+ * @param json The JSON string, without its closing quote.
+ * @param text The text to append.
+ */
+static void append_json(std::string* json, const std::string& text) {
+	for (unsigned char c : text) {
+		if (c == '"' || c == '\\') {
+			*json += '\\';
+			*json += c;
+		} else if (c < 0x20 || c == 0x7f) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			*json += escaped;
+		} else {
+			*json += c;
+		}
+	}
+}
+
+/**
+ * Writes the recording in large chunks, compressing them first if
+ * requested. Only used by the recording thread.
+ */
+struct CastWriter {
+	Recorder* recorder;
+	int fd;
+	std::string buffer;
+#ifdef SNAKEGAME_ZSTD
+	ZSTD_CCtx* context = nullptr;
+	std::vector<char> compressed;
+#endif
+
+	CastWriter(Recorder* recorder, int fd) :
+			recorder(recorder), fd(fd) {
+		buffer.reserve(RECORDER_CHUNK_SIZE * 2);
+#ifdef SNAKEGAME_ZSTD
+		if (recorder->compress) {
+			context = ZSTD_createCCtx();
+			compressed.resize(ZSTD_CStreamOutSize());
+			// never fall back to writing plain text into a .zst file
+			recorder->write_failed = context == nullptr;
+		}
+#endif
+	}
+
+	~CastWriter() {
+#ifdef SNAKEGAME_ZSTD
+		ZSTD_freeCCtx(context);
+#endif
+	}
+
+	/**
+	 * Write bytes to the file, giving up on the first error.
+	 * @param data The bytes to write.
+	 * @param size The number of bytes.
+	 */
+	void write_all(const char* data, size_t size) {
+		while (size > 0 && !recorder->write_failed) {
+			ssize_t written = write(fd, data, size);
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			if (written <= 0) {
+				recorder->write_failed = true;
+				return;
+			}
+			recorder->bytes_written += written;
+			data += written;
+			size -= written;
+		}
+	}
+
+	/**
+	 * Write out the buffer once it holds a full chunk.
+	 * @param end true to write it out regardless, ending the recording.
+	 */
+	void flush(bool end) {
+		if (!end && buffer.size() < RECORDER_CHUNK_SIZE) {
+			return;
+		}
+#ifdef SNAKEGAME_ZSTD
+		if (context != nullptr) {
+			ZSTD_inBuffer in = { buffer.data(), buffer.size(), 0 };
+			ZSTD_EndDirective mode = end ? ZSTD_e_end : ZSTD_e_continue;
+			size_t remaining;
+			do {
+				ZSTD_outBuffer out = { compressed.data(), compressed.size(), 0 };
+				remaining = ZSTD_compressStream2(context, &out, &in, mode);
+				if (ZSTD_isError(remaining)) {
+					recorder->write_failed = true;
+					break;
+				}
+				write_all(compressed.data(), out.pos);
+			} while (end ? remaining != 0 : in.pos < in.size);
+			buffer.clear();
+			return;
+		}
+#endif
+		write_all(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+};
+
+/**
+ * Turns queued events into asciicast output events, moving the cursor
+ * and changing colors only when a cell needs it. Only used by the
+ * recording thread.
+ */
+struct CastEncoder {
+	int width;
+	int x = -1;  // where the cursor is, or -1 if unknown
+	int y = -1;
+	int fg = -2; // the colors in effect, or -2 if unknown
+	int bg = -2;
+	std::string frame;
+
+	/**
+	 * Add a changed cell to the current frame.
+	 * @param event The CAST_CELL event.
+	 */
+	void cell(const CastEvent& event) {
+		if (event.x != x || event.y != y) {
+			frame += "\\u001b[" + std::to_string(event.y + 1) + ";"
+			        + std::to_string(event.x + 1) + "H";
+		}
+		if (event.fg != fg || event.bg != bg) {
+			frame += "\\u001b[0";
+			if (event.fg >= 0) {
+				frame += ";3" + std::to_string(event.fg);
+			}
+			if (event.bg >= 0) {
+				frame += ";4" + std::to_string(event.bg);
+			}
+			frame += "m";
+			fg = event.fg;
+			bg = event.bg;
+		}
+		append_json(&frame, std::string(1, event.c));
+		x = event.x + 1;
+		y = event.y;
+		if (x >= width) {
+			// the terminal may or may not have wrapped
+			x = -1;
+		}
+	}
+
+	/**
+	 * End the current frame, adding it to the recording.
+	 * @param event The CAST_FRAME event.
+	 * @param start_us When the recording started.
+	 * @param out The recording.
+	 */
+	void end_frame(const CastEvent& event, int64_t start_us, std::string* out) {
+		if (frame.empty()) {
+			return;
+		}
+		char time[32];
+		snprintf(time, sizeof(time), "[%.6f, \"o\", \"", (event.time_us - start_us) / 1e6);
+		*out += time;
+		*out += frame;
+		*out += "\"]\n";
+		frame.clear();
+	}
+};
+
+/**
+ * Create a Recorder for a screen of the given size.
+ * @param path The file to record to.
+ * @param width The width of the screen.
+ * @param height The height of the screen.
+ * @param compress true to zstd compress the file, if RECORDER_ZSTD.
+ */
+Recorder::Recorder(const std::string& path, int width, int height, bool compress) :
+		path(path), width(width), height(height), compress(compress && RECORDER_ZSTD),
+		        queue(RECORDER_QUEUE_SIZE), write_index(0), read_index(0), running(false) {
+}
+
+/**
+ * Stop recording, if still recording.
+ */
+Recorder::~Recorder() {
+	stop();
+}
+
+/**
+ * Open the file and start the recording thread.
+ * @return true if the file could be opened.
+ */
+bool Recorder::start() {
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	start_us = now_us();
+	running = true;
+	thread = std::thread(&Recorder::run, this, fd);
+	return true;
+}
+
+/**
+ * Queue an event without blocking, counting it as dropped if the
+ * queue is full.
+ * @param event The event to queue.
+ * @return true if the event was queued.
+ */
+bool Recorder::push(const CastEvent& event) {
+	uint64_t w = write_index.load(std::memory_order_relaxed);
+	uint64_t waiting = w - read_index.load(std::memory_order_acquire);
+	if (waiting >= queue.size()) {
+		dropped++;
+		return false;
+	}
+	queue[w & (queue.size() - 1)] = event;
+	write_index.store(w + 1, std::memory_order_release);
+	events++;
+	if (waiting + 1 > peak) {
+		peak = waiting + 1;
+	}
+	return true;
+}
+
+/**
+ * Queue a cell drawn on the screen.
+ * @param x The column of the cell.
+ * @param y The row of the cell.
+ * @param c The character drawn.
+ * @param fg The foreground color, as an ANSI color number, or -1.
+ * @param bg The background color, as an ANSI color number, or -1.
+ */
+void Recorder::cell(int x, int y, char c, int fg, int bg) {
+	CastEvent event;
+	event.time_us = 0;
+	event.x = x;
+	event.y = y;
+	event.type = CAST_CELL;
+	event.fg = fg;
+	event.bg = bg;
+	event.c = c;
+	push(event);
+}
+
+/**
+ * Mark the end of a frame: the cells queued since the last frame
+ * were just shown on the screen.
+ */
+void Recorder::frame() {
+	CastEvent event;
+	event.time_us = now_us();
+	event.x = 0;
+	event.y = 0;
+	event.type = CAST_FRAME;
+	event.fg = -1;
+	event.bg = -1;
+	event.c = 0;
+	uint64_t waiting = write_index.load(std::memory_order_relaxed)
+	        - read_index.load(std::memory_order_acquire);
+	if (waiting > queue.size() / 2) {
+		backpressured++;
+	}
+	if (push(event)) {
+		frames++;
+	}
+}
+
+/**
+ * Write out everything queued, and stop the recording thread.
+ */
+void Recorder::stop() {
+	if (thread.joinable()) {
+		running.store(false, std::memory_order_release);
+		thread.join();
+	}
+}
+
+/**
+ * Describe how the recording went, for after the game ends.
+ * @return A one-line report.
+ */
+std::string Recorder::report() {
+	std::string text = "Recorded " + std::to_string(frames) + " frames ("
+	        + std::to_string(bytes_written / 1024) + " KB) to \"" + path + "\"";
+	if (write_failed) {
+		text += ", but writing failed, so the recording is incomplete";
+	}
+	if (dropped > 0) {
+		text += ", dropping " + std::to_string(dropped) + " events";
+	}
+	text += ". The queue peaked at " + std::to_string(peak) + " of "
+	        + std::to_string(queue.size()) + " events";
+	if (backpressured > 0) {
+		text += " and was over half full for " + std::to_string(backpressured) + " frames";
+	}
+	return text + ".";
+}
+
+/**
+ * The body of the recording thread.
+ * @param fd The file to write to.
+ */
+void Recorder::run(int fd) {
+	CastWriter writer(this, fd);
+	CastEncoder encoder;
+	encoder.width = width;
+
+	// the header, then hide the cursor and clear the screen
+	const char* term = getenv("TERM");
+	writer.buffer = "{\"version\": 2, \"width\": " + std::to_string(width) + ", \"height\": "
+	        + std::to_string(height) + ", \"timestamp\": " + std::to_string(time(0))
+	        + ", \"env\": {\"TERM\": \"";
+	append_json(&writer.buffer, term != nullptr ? term : "xterm");
+	writer.buffer += "\"}}\n";
+	encoder.frame = "\\u001b[?25l\\u001b[H\\u001b[2J";
+
+	const uint64_t mask = queue.size() - 1;
+	while (true) {
+		// anything queued before running was cleared is drained below
+		bool stopping = !running.load(std::memory_order_acquire);
+		uint64_t r = read_index.load(std::memory_order_relaxed);
+		uint64_t w = write_index.load(std::memory_order_acquire);
+		for (; r < w; r++) {
+			CastEvent& event = queue[r & mask];
+			if (event.type == CAST_FRAME) {
+				encoder.end_frame(event, start_us, &writer.buffer);
+				writer.flush(false);
+				// free the frame's slots now, not after the whole batch
+				read_index.store(r + 1, std::memory_order_release);
+			} else {
+				encoder.cell(event);
+			}
+		}
+		read_index.store(r, std::memory_order_release);
+		if (stopping) {
+			break;
+		}
+		if (r == w) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+	writer.flush(true);
+	close(fd);
+}
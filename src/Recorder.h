@@ -0,0 +1,151 @@
+/*
+ * Recorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdbool.h>
+
+/**
+ * Whether recordings can be zstd compressed. Build with
+ * -DSNAKEGAME_ZSTD and -lzstd to enable it.
+ */
+#ifdef SNAKEGAME_ZSTD
+#define RECORDER_ZSTD true
+#else
+#define RECORDER_ZSTD false
+#endif
+
+/**
+ * The number of events the queue between the game and the recording
+ * thread can hold. Must be a power of two.
+ */
+#define RECORDER_QUEUE_SIZE (1 << 16)
+
+/**
+ * How many bytes of the recording are buffered before each write.
+ */
+#define RECORDER_CHUNK_SIZE (1 << 20)
+
+/**
+ * One change to the screen, as queued by the game.
+ */
+struct CastEvent {
+	int64_t time_us;  // FRAME: when the frame was shown
+	uint16_t x;       // CELL: the screen cell that changed
+	uint16_t y;
+	uint8_t type;     // CAST_CELL or CAST_FRAME
+	int8_t fg;        // CELL: the colors, as ANSI color numbers, or -1
+	int8_t bg;
+	char c;           // CELL: the character drawn
+};
+
+#define CAST_CELL  0
+#define CAST_FRAME 1
+
+/**
+ * Records the screen of a session in the asciicast v2 format.
+ *
+ * The game only queues the cells it draws and marks the end of each
+ * frame; neither blocks or makes a system call. A background thread
+ * turns the queue into escape sequences and writes them out in large
+ * chunks, zstd compressed if requested. If the queue is ever full, the
+ * game drops the event rather than wait, and the drop is counted.
+ */
+struct Recorder {
+	std::string path;
+	int width;
+	int height;
+	bool compress;
+
+	// the queue, written by the game and read by the recording thread
+	std::vector<CastEvent> queue;
+	std::atomic<uint64_t> write_index;
+	std::atomic<uint64_t> read_index;
+	std::atomic<bool> running;
+	std::thread thread;
+	int64_t start_us = 0;
+
+	// counted by the game
+	uint64_t events = 0;
+	uint64_t frames = 0;
+	uint64_t dropped = 0;        // events lost to a full queue
+	uint64_t backpressured = 0;  // frames that found the queue over half full
+	uint64_t peak = 0;           // most events ever waiting in the queue
+
+	// counted by the recording thread
+	uint64_t bytes_written = 0;
+	bool write_failed = false;
+
+	/**
+	 * Create a Recorder for a screen of the given size.
+	 * @param path The file to record to.
+	 * @param width The width of the screen.
+	 * @param height The height of the screen.
+	 * @param compress true to zstd compress the file, if RECORDER_ZSTD.
+	 */
+	Recorder(const std::string& path, int width, int height, bool compress);
+
+	/**
+	 * Stop recording, if still recording.
+	 */
+	~Recorder();
+
+	/**
+	 * Open the file and start the recording thread.
+	 * @return true if the file could be opened.
+	 */
+	bool start();
+
+	/**
+	 * Queue a cell drawn on the screen.
+	 * @param x The column of the cell.
+	 * @param y The row of the cell.
+	 * @param c The character drawn.
+	 * @param fg The foreground color, as an ANSI color number, or -1.
+	 * @param bg The background color, as an ANSI color number, or -1.
+	 */
+	void cell(int x, int y, char c, int fg, int bg);
+
+	/**
+	 * Mark the end of a frame: the cells queued since the last frame
+	 * were just shown on the screen.
+	 */
+	void frame();
+
+	/**
+	 * Write out everything queued, and stop the recording thread.
+	 */
+	void stop();
+
+	/**
+	 * Describe how the recording went, for after the game ends.
+	 * @return A one-line report.
+	 */
+	std::string report();
+
+	/**
+	 * Queue an event without blocking, counting it as dropped if the
+	 * queue is full.
+	 * @param event The event to queue.
+	 * @return true if the event was queued.
+	 */
+	bool push(const CastEvent& event);
+
+	/**
+	 * The body of the recording thread.
+	 * @param fd The file to write to.
+	 */
+	void run(int fd);
+};
+
+#endif /* RECORDER_H_ */
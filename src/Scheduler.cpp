@@ -0,0 +1,162 @@
+/*
+ * Scheduler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include "Scheduler.h"
+
+/**
+ * Create an empty Scheduler.
+ * @param start_us The current time, in microseconds.
+ */
+Scheduler::Scheduler(int64_t start_us) :
+		slots(SCHEDULER_SLOTS, -1), now_us(start_us), next_slot(start_us / SCHEDULER_SLOT_US) {
+}
+
+/**
+ * Start driving a Game, with its first tick due after one
+ * tick_interval() from now.
+ * @param game The Game to drive, which must outlive its Session.
+ * @return The index of the Game's Session.
+ */
+int Scheduler::add(Game* game) {
+	int id;
+	if (!free_sessions.empty()) {
+		id = free_sessions.back();
+		free_sessions.pop_back();
+	} else {
+		id = sessions.size();
+		sessions.emplace_back();
+	}
+	Session& session = sessions[id];
+	session.game = game;
+	session.deadline_us = now_us + game->tick_interval();
+	link(id);
+	return id;
+}
+
+/**
+ * Stop driving a Game. The Game itself is left to the caller.
+ * @param id The index of the Game's Session.
+ */
+void Scheduler::remove(int id) {
+	if (sessions[id].scheduled) {
+		unlink(id);
+	}
+	sessions[id].game = nullptr;
+	free_sessions.push_back(id);
+}
+
+/**
+ * Tick every Game whose deadline has passed by the given time.
+ * Ticks are never early, and at most one slot late.
+ * @param time_us The current time, in microseconds.
+ * @return The number of ticks.
+ */
+long Scheduler::run_until(int64_t time_us) {
+	long count = 0;
+	int64_t end_slot = time_us / SCHEDULER_SLOT_US;
+	if (scheduled_count == 0 && end_slot > next_slot) {
+		next_slot = end_slot;
+	}
+
+	// visit each slot that has fully passed
+	for (; next_slot < end_slot; next_slot++) {
+		int64_t slot_end = (next_slot + 1) * SCHEDULER_SLOT_US;
+		now_us = slot_end;
+		int& head = slots[next_slot & SCHEDULER_SLOT_MASK];
+		int id = head;
+		head = -1;
+
+		while (id != -1) {
+			int following = sessions[id].next;
+			if (sessions[id].deadline_us >= slot_end) {
+				// due on a later turn of the wheel
+				link(id);
+				id = following;
+				continue;
+			}
+			sessions[id].scheduled = false;
+			scheduled_count--;
+
+			Game* game = sessions[id].game;
+			TickResult result = game->tick();
+			count++;
+			ticks++;
+			if (result != TickResult::GAME_OVER && result != TickResult::VICTORY && !game->quit) {
+				// keep to the original rhythm, but never fall into a slot
+				// already visited if the caller is running late
+				Session& session = sessions[id];
+				session.deadline_us += game->tick_interval();
+				if (session.deadline_us < slot_end) {
+					session.deadline_us = slot_end + game->tick_interval();
+				}
+				link(id);
+			}
+			if (on_tick) {
+				on_tick(id, game, result);
+			}
+			id = following;
+		}
+	}
+	now_us = time_us;
+	return count;
+}
+
+/**
+ * Get the time by which run_until() next has a tick to do.
+ * @return The time, in microseconds, or -1 if no Game is scheduled.
+ */
+int64_t Scheduler::next_deadline() {
+	if (scheduled_count == 0) {
+		return -1;
+	}
+	for (int64_t k = next_slot; k < next_slot + SCHEDULER_SLOTS; k++) {
+		int64_t slot_end = (k + 1) * SCHEDULER_SLOT_US;
+		for (int id = slots[k & SCHEDULER_SLOT_MASK]; id != -1; id = sessions[id].next) {
+			if (sessions[id].deadline_us < slot_end) {
+				return slot_end;
+			}
+		}
+	}
+	return (next_slot + SCHEDULER_SLOTS) * SCHEDULER_SLOT_US;
+}
+
+/**
+ * Put a Session in the slot of its deadline.
+ * @param id The index of the Session.
+ */
+void Scheduler::link(int id) {
+	Session& session = sessions[id];
+	int& head = slots[(session.deadline_us / SCHEDULER_SLOT_US) & SCHEDULER_SLOT_MASK];
+	session.prev = -1;
+	session.next = head;
+	if (head != -1) {
+		sessions[head].prev = id;
+	}
+	head = id;
+	if (!session.scheduled) {
+		session.scheduled = true;
+		scheduled_count++;
+	}
+}
+
+/**
+ * Take a Session out of its slot.
+ * @param id The index of the Session.
+ */
+void Scheduler::unlink(int id) {
+	Session& session = sessions[id];
+	if (session.prev != -1) {
+		sessions[session.prev].next = session.next;
+	} else {
+		slots[(session.deadline_us / SCHEDULER_SLOT_US) & SCHEDULER_SLOT_MASK] = session.next;
+	}
+	if (session.next != -1) {
+		sessions[session.next].prev = session.prev;
+	}
+	session.scheduled = false;
+	scheduled_count--;
+}
@@ -0,0 +1,114 @@
+/*
+ * Scheduler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <stdbool.h>
+#include "Game.h"
+
+/**
+ * The timer wheel has SCHEDULER_SLOTS slots of SCHEDULER_SLOT_US each.
+ * One turn of the wheel must be longer than the longest tick_interval(),
+ * so a Game is always due within one turn. SCHEDULER_SLOTS must be a
+ * power of two.
+ */
+#define SCHEDULER_SLOT_US 1000
+#define SCHEDULER_SLOTS 256
+#define SCHEDULER_SLOT_MASK (SCHEDULER_SLOTS - 1)
+
+/**
+ * One Game driven by a Scheduler. Sessions due in the same slot of the
+ * wheel form a doubly linked list of indices into Scheduler::sessions.
+ */
+struct Session {
+	Game* game = nullptr;
+	int64_t deadline_us = 0;  // when the next tick is due
+	int prev = -1;
+	int next = -1;
+	bool scheduled = false;   // linked into the wheel
+};
+
+/**
+ * Drives any number of Games on a single thread, ticking each one once
+ * its tick_interval() has passed.
+ *
+ * Each Game waits in the slot of a timer wheel for its next deadline,
+ * so advancing time only visits the slots that passed and the Games due
+ * in them, however many Games are waiting. The Scheduler never reads
+ * the clock or sleeps: the caller passes in the time, and can sleep
+ * until next_deadline(). A Game that ends stays in its Session, no
+ * longer scheduled, until the caller removes it.
+ */
+struct Scheduler {
+	std::vector<Session> sessions;
+	std::vector<int> free_sessions;
+	std::vector<int> slots;  // the first Session in each slot, or -1
+
+	int64_t now_us;          // the time the wheel has advanced to
+	int64_t next_slot;       // the first slot not yet visited
+	int scheduled_count = 0;
+	long ticks = 0;
+
+	/**
+	 * Called after every tick with the Session's index, its Game and
+	 * the result of the tick. It may add Games, and may remove the
+	 * Session it was called for, but no other.
+	 */
+	std::function<void(int, Game*, TickResult)> on_tick;
+
+	/**
+	 * Create an empty Scheduler.
+	 * @param start_us The current time, in microseconds.
+	 */
+	Scheduler(int64_t start_us);
+
+	/**
+	 * Start driving a Game, with its first tick due after one
+	 * tick_interval() from now.
+	 * @param game The Game to drive, which must outlive its Session.
+	 * @return The index of the Game's Session.
+	 */
+	int add(Game* game);
+
+	/**
+	 * Stop driving a Game. The Game itself is left to the caller.
+	 * @param id The index of the Game's Session.
+	 */
+	void remove(int id);
+
+	/**
+	 * Tick every Game whose deadline has passed by the given time.
+	 * Ticks are never early, and at most one slot late.
+	 * @param time_us The current time, in microseconds.
+	 * @return The number of ticks.
+	 */
+	long run_until(int64_t time_us);
+
+	/**
+	 * Get the time by which run_until() next has a tick to do.
+	 * @return The time, in microseconds, or -1 if no Game is scheduled.
+	 */
+	int64_t next_deadline();
+
+	/**
+	 * Put a Session in the slot of its deadline.
+	 * @param id The index of the Session.
+	 */
+	void link(int id);
+
+	/**
+	 * Take a Session out of its slot.
+	 * @param id The index of the Session.
+	 */
+	void unlink(int id);
+};
+
+#endif /* SCHEDULER_H_ */
@@ -5,6 +5,8 @@
  *      Author: aaron
  */
 
+#include <cstring>
+
 #include "Snake.h"
 
 /**
@@ -28,120 +30,110 @@ std::string direction_name(Direction direction) {
 }
 
 /**
- * Index used to differentiate different Segments.
+ * Get the next Point towards which the Snake should move,
+ * based on the Snake's current Direction.
+ * @return The next Point towards which the Snake should move.
  */
-int segment_index = 1;
-
-Segment::Segment() {
-	// It doesn't matter if this value rolls over,
-	// it only needs to be unique per "alive" Segments in Snake.
-	// Snake.segment_count will never be greater than ROWS * COLS.
-	index = segment_index++;
+Point Snake::get_next_move() {
+	int d = static_cast<int>(direction);
+	Point head = this->head();
+	return Point(head.x + DIRECTION_DX[d], head.y + DIRECTION_DY[d]);
 }
 
 /**
- * Get a string representation of this Segment's fields and references.
- * @return A string describing this Segment.
+ * Grow the Snake one additional cell towards the input Point.
+ * @param point The Point towards which to grow the Snake.
  */
-std::string Segment::to_string() {
-	std::string str = "{index: " + std::to_string(index) + ", next: "
-	        + (next == nullptr ? "nullptr" : std::to_string(next->index)) + ", prev: "
-	        + (prev == nullptr ? "nullptr" : std::to_string(prev->index)) + ", p: "
-	        + point->to_string() + "}";
-	return str;
+void Snake::grow(Point point) {
+	if ((size_t) segment_count == body.size()) {
+		expand();
+	}
+	head_index = (head_index - 1) & (body.size() - 1);
+	body[head_index] = point;
+	mark(point);
+	segment_count++;
 }
 
 /**
- * Get the next Point towards which the Snake should move,
- * based on the Snake's current Direction.
- * @return The next Point towards which the Snake should move.
+ * Move the Snake towards the input Point.
+ * @param point The Point towards which to move the Snake.
  */
-Point* Snake::get_next_move() {
-	int nx = 0;
-	int ny = 0;
-	Direction direction = this->direction;
-	switch (direction) {
-	case Direction::UP:
-		nx = 0;
-		ny = -1;
-		break;
-	case Direction::DOWN:
-		nx = 0;
-		ny = 1;
-		break;
-	case Direction::LEFT:
-		nx = -1;
-		ny = 0;
-		break;
-	case Direction::RIGHT:
-		nx = 1;
-		ny = 0;
-		break;
-	}
-	nx += head->x();
-	ny += head->y();
-	return new Point(nx, ny);
+void Snake::move(Point point) {
+	// free the tail first, so the head may take its cell
+	Point old_tail = tail();
+	unmark(old_tail);
+	head_index = (head_index - 1) & (body.size() - 1);
+	body[head_index] = point;
+	mark(point);
 }
 
 /**
- * Grow the Snake one additional Segment towards the input Point.
- * @param point The Point towards which to grow the Snake.
+ * Remove the Snake's head, undoing a call to grow().
+ * The Snake must have at least two cells.
+ * @return The removed head.
  */
-void Snake::grow(Point* point) {
-	Segment* new_head = new Segment();
-	new_head->point = point;
+Point Snake::pop_head() {
+	Point point = head();
+	unmark(point);
+	head_index = (head_index + 1) & (body.size() - 1);
+	segment_count--;
+	return point;
+}
 
-	// set head == tail
-	if (segment_count == 0) {
-		new_head->prev = nullptr;
-		new_head->next = nullptr;
-		head = new_head;
-		tail = new_head;
-	}
-	// decouple head and tail
-	else if (segment_count == 1) {
-		new_head->prev = nullptr;
-		new_head->next = tail;
-		new_head->next->prev = new_head;
-		new_head->next->next = nullptr;
-		head = new_head;
-	}
-	// general case movement
-	else {
-		new_head->prev = nullptr;
-		new_head->next = head;
-		new_head->next->prev = new_head;
-		head = new_head;
+/**
+ * Append a cell after the Snake's tail, undoing the tail
+ * removal performed by move().
+ * @param point The new tail.
+ */
+void Snake::push_tail(Point point) {
+	if ((size_t) segment_count == body.size()) {
+		expand();
 	}
 	segment_count++;
+	body[(head_index + segment_count - 1) & (body.size() - 1)] = point;
+	mark(point);
 }
 
 /**
- * Move the Snake towards the input Point.
- * @param point The Point towards which to move the Snake.
+ * Replace the Snake's body with the given cells, copying them in
+ * with a single memcpy.
+ * @param cells The cells, from head to tail, as (x, y) int32_t pairs.
+ * @param count The number of cells, at least one.
+ * @return false if a cell repeats, leaving the Snake's occupancy
+ *         incomplete; the Snake should then be discarded.
  */
-void Snake::move(Point* point) {
-	grow(point);
-	segment_count--;
+bool Snake::assign(const void* cells, int count) {
+	static_assert(sizeof(Point) == 2 * sizeof(int32_t), "Point must be two int32_t");
+	for (int i = 0; i < segment_count; i++) {
+		unmark(segment(i));
+	}
+	size_t capacity = SNAKE_INITIAL_CAPACITY;
+	while (capacity < (size_t) count) {
+		capacity *= 2;
+	}
+	if (body.size() < capacity) {
+		body.resize(capacity);
+	}
+	memcpy(body.data(), cells, count * sizeof(Point));
+	head_index = 0;
+	segment_count = count;
 
-	Segment* old_tail = tail;
-	tail = tail->prev;
-	tail->next = nullptr;
-	delete old_tail->point;
-	delete old_tail;
+	for (int i = 0; i < count; i++) {
+		if (!mark(body[i])) {
+			return false;
+		}
+	}
+	return true;
 }
 
 /**
- * Check if any of the Snake's Segments contain the given Point.
- * @param p The Point to check.
- * @return true if the Snake's Segments contain the given Point,
- *         else false.
+ * Double the ring, keeping the body in order from the head.
  */
-bool Snake::contains(Point* point) {
-	for (Segment* s = head; s != nullptr; s = s->next) {
-		if (point->equals(s->point)) {
-			return true;
-		}
+void Snake::expand() {
+	std::vector<Point> bigger(body.size() * 2);
+	for (int i = 0; i < segment_count; i++) {
+		bigger[i] = segment(i);
 	}
-	return false;
+	body.swap(bigger);
+	head_index = 0;
 }
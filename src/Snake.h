@@ -8,16 +8,14 @@
 #ifndef SNAKE_H_
 #define SNAKE_H_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <stdbool.h>
 #include "Point.h"
-
-/**
- * Represents the four basic directions.
- */
-enum class Direction {
-	UP, DOWN, LEFT, RIGHT
-};
+#include "Grid.h"
+#include "Level.h"
+#include "Direction.h"
 
 /**
  * Get the string name of this Direction.
@@ -27,65 +25,175 @@ enum class Direction {
 std::string direction_name(Direction d);
 
 /**
- * Represents a single segment of the snake.
+ * The number of cells a Snake's body can hold before it first grows
+ * its ring. Must be a power of two.
  */
-struct Segment {
-	Point* point = nullptr;
-	Segment* next = nullptr;
-	Segment* prev = nullptr;
-	int index;
-	Segment();
-
-	/**
-	 * Get a string representation of this Segment's fields and references.
-	 * @return A string describing this Segment.
-	 */
-	std::string to_string();
-	int x() {
-		return point->x;
-	}
-	int y() {
-		return point->y;
-	}
-};
+#define SNAKE_INITIAL_CAPACITY 16
 
 /**
  * Hold information for the snake.
+ *
+ * The body is a ring buffer of cells in one contiguous block, read from
+ * the head to the tail. Growing and moving write a single cell and only
+ * allocate when the ring is full and doubles, and a whole body can be
+ * restored with one memcpy through assign().
+ *
+ * Which cells the body covers is tracked in the sparse occupied Grid,
+ * unless cells is set, in which case LEVEL_CELL_BODY is set in that
+ * dense array instead, so a level's walls and the body share one lookup.
+ * An owner that tracks the cells of many Snakes itself, like the Arena,
+ * turns tracking off.
  */
 struct Snake {
 	Direction direction = Direction::RIGHT;
-	Segment* head = nullptr;
-	Segment* tail = nullptr;
+	std::vector<Point> body = std::vector<Point>(SNAKE_INITIAL_CAPACITY);
+	size_t head_index = 0;  // body[head_index] is the head
 	int segment_count = 0;
 	bool pause = false;
 	bool game_over = false;
 
+	/**
+	 * The cells covered by the Snake's body, kept in sync by grow(),
+	 * move(), pop_head(), push_tail() and assign(). Unused when cells
+	 * is set.
+	 */
+	Grid occupied;
+
+	/**
+	 * A dense array of level cells, row by row, in which to mark the
+	 * body with LEVEL_CELL_BODY instead of using occupied, or nullptr.
+	 * Not owned by the Snake.
+	 */
+	uint8_t* cells = nullptr;
+	int cells_width = 0;
+
+	/**
+	 * Whether the Snake tracks its own cells at all. When false,
+	 * contains() is always false and assign() can't detect repeats.
+	 */
+	bool track_cells = true;
+
+	/**
+	 * Get one cell of the Snake's body.
+	 * @param i The position of the cell, 0 for the head.
+	 * @return The cell.
+	 */
+	Point segment(int i) const {
+		return body[(head_index + i) & (body.size() - 1)];
+	}
+
+	/**
+	 * Get the cell of the Snake's head.
+	 * @return The head.
+	 */
+	Point head() const {
+		return body[head_index];
+	}
+
+	/**
+	 * Get the cell of the Snake's tail.
+	 * @return The tail.
+	 */
+	Point tail() const {
+		return segment(segment_count - 1);
+	}
+
 	/**
 	 * Get the next Point towards which the Snake should move,
 	 * based on the Snake's current Direction.
 	 * @return The next Point towards which the Snake should move.
 	 */
-	Point* get_next_move();
+	Point get_next_move();
 
 	/**
-	 * Grow the Snake one additional Segment towards the input Point.
+	 * Grow the Snake one additional cell towards the input Point.
 	 * @param point The Point towards which to grow the Snake.
 	 */
-	void grow(Point* point);
+	void grow(Point point);
 
 	/**
 	 * Move the Snake towards the input Point.
 	 * @param point The Point towards which to move the Snake.
 	 */
-	void move(Point* point);
+	void move(Point point);
+
+	/**
+	 * Remove the Snake's head, undoing a call to grow().
+	 * The Snake must have at least two cells.
+	 * @return The removed head.
+	 */
+	Point pop_head();
+
+	/**
+	 * Append a cell after the Snake's tail, undoing the tail
+	 * removal performed by move().
+	 * @param point The new tail.
+	 */
+	void push_tail(Point point);
+
+	/**
+	 * Replace the Snake's body with the given cells, copying them in
+	 * with a single memcpy.
+	 * @param cells The cells, from head to tail, as (x, y) int32_t pairs.
+	 * @param count The number of cells, at least one.
+	 * @return false if a cell repeats, leaving the Snake's occupancy
+	 *         incomplete; the Snake should then be discarded.
+	 */
+	bool assign(const void* cells, int count);
+
+	/**
+	 * Check if the Snake's body covers the given cell.
+	 * @param x The x coordinate of the cell.
+	 * @param y The y coordinate of the cell.
+	 * @return true if the Snake's body covers the cell, else false.
+	 */
+	bool contains(int x, int y) const {
+		if (!track_cells) {
+			return false;
+		}
+		if (cells != nullptr) {
+			return cells[(size_t) y * cells_width + x] & LEVEL_CELL_BODY;
+		}
+		return occupied.get(x, y);
+	}
+
+	/**
+	 * Mark a cell as covered by the body.
+	 * @param point The cell.
+	 * @return true if the cell was not covered before, else false.
+	 */
+	bool mark(Point point) {
+		if (!track_cells) {
+			return true;
+		}
+		if (cells != nullptr) {
+			uint8_t& cell = cells[(size_t) point.y * cells_width + point.x];
+			bool was_free = !(cell & LEVEL_CELL_BODY);
+			cell |= LEVEL_CELL_BODY;
+			return was_free;
+		}
+		return occupied.set(point.x, point.y);
+	}
+
+	/**
+	 * Mark a cell as no longer covered by the body.
+	 * @param point The cell.
+	 */
+	void unmark(Point point) {
+		if (!track_cells) {
+			return;
+		}
+		if (cells != nullptr) {
+			cells[(size_t) point.y * cells_width + point.x] &= ~LEVEL_CELL_BODY;
+		} else {
+			occupied.clear(point.x, point.y);
+		}
+	}
 
 	/**
-	 * Check if any of the Snake's Segments contain the given Point.
-	 * @param p The Point to check.
-	 * @return true if the Snake's Segments contain the given Point,
-	 *         else false.
+	 * Double the ring, keeping the body in order from the head.
 	 */
-	bool contains(Point* point);
+	void expand();
 };
 
 #endif /* SNAKE_H_ */
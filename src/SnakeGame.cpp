@@ -11,98 +11,29 @@
 #include <cstring>
 #include <random>
 #include <regex>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <thread>
 
 #include <ncurses.h>
 #include <stdbool.h>
 #include <unistd.h>
-#include <pthread.h>
 
 #include "Point.h"
 #include "Keys.h"
 #include "Snake.h"
+#include "Game.h"
+#include "Snapshot.h"
+#include "History.h"
+#include "Level.h"
+#include "Leaderboard.h"
+#include "Recorder.h"
+#include "Arena.h"
 
 #define ENUM_CAST(e) static_cast<typename std::underlying_type<Direction>::type>(e)
 
-/**
- * Read the user input.  Intended to be run on a separate thread
- * via passing as an argument to {@code pthread_create}.
- * @param vargp The Snake to be updated by the user input.
- */
-void* read_user_input(void* vargp) {
-	Snake* snake = (Snake*) vargp;
-	while (!snake->game_over) {
-		int input = getch();
-		switch (input) {
-		case A_KEY_A:
-		case A_KEY_H:
-		case A_KEY_LEFT:
-		case KEY_LEFT:
-			if (snake->direction != Direction::LEFT && snake->direction != Direction::RIGHT) {
-				snake->direction = Direction::LEFT;
-				snake->pause = false;
-			}
-			break;
-		case A_KEY_S:
-		case A_KEY_J:
-		case A_KEY_DOWN:
-		case KEY_DOWN:
-			if (snake->direction != Direction::DOWN && snake->direction != Direction::UP) {
-				snake->direction = Direction::DOWN;
-				snake->pause = false;
-			}
-			break;
-		case A_KEY_W:
-		case A_KEY_K:
-		case A_KEY_UP:
-		case KEY_UP:
-			if (snake->direction != Direction::UP && snake->direction != Direction::DOWN) {
-				snake->direction = Direction::UP;
-				snake->pause = false;
-			}
-			break;
-		case A_KEY_D:
-		case A_KEY_L:
-		case A_KEY_RIGHT:
-		case KEY_RIGHT:
-			if (snake->direction != Direction::RIGHT && snake->direction != Direction::LEFT) {
-				snake->direction = Direction::RIGHT;
-				snake->pause = false;
-			}
-			break;
-		case A_KEY_P:
-		case A_KEY_SPACE:
-			snake->pause = !snake->pause;
-			break;
-		case A_KEY_Q:
-		case A_KEY_ESCAPE:
-			endwin();
-			exit(0);
-			break;
-//		case A_KEY_C:
-//			snake->segment_count = COLS * LINES - 1;
-//			break;
-		}
-	}
-	return nullptr;
-}
-
-/**
- * Variables used for RNG.
- */
-std::default_random_engine random_engine;
-std::uniform_int_distribution<int> width_dist;
-std::uniform_int_distribution<int> height_dist;
-
-/**
- * Get a random Point within the range of ROWS and COLS.
- * @return a random Point within the range of ROWS and COLS.
- */
-Point* get_random_point() {
-	int x = width_dist(random_engine);
-	int y = height_dist(random_engine);
-	return new Point(x, y);
-}
-
 /**
  * Enum used for color definitions with ncurses.
  */
@@ -136,11 +67,67 @@ void init_colors() {
 }
 
 /**
- * Used to define the game's difficulty setting.
+ * The recording of this session, or nullptr if --cast was not given.
  */
-enum class Difficulty {
-	EASY, NORMAL, HARD
-};
+Recorder* recorder = nullptr;
+
+/**
+ * The colors last set with set_color(), as ANSI color numbers, or -1
+ * for the terminal's default.
+ */
+short current_fg = -1;
+short current_bg = -1;
+
+/**
+ * Draw with the given color from now on.
+ * @param color The Color to use.
+ */
+void set_color(Color color) {
+	attron(COLOR_PAIR(color));
+	if (recorder != nullptr && pair_content(color, &current_fg, &current_bg) == ERR) {
+		current_fg = -1;
+		current_bg = -1;
+	}
+}
+
+/**
+ * Draw a character on the screen, recording it if --cast was given.
+ * @param y The row to draw on.
+ * @param x The column to draw in.
+ * @param c The character to draw.
+ */
+void put_char(int y, int x, char c) {
+	mvaddch(y, x, c);
+	if (recorder != nullptr) {
+		recorder->cell(x, y, c, current_fg, current_bg);
+	}
+}
+
+/**
+ * Draw a string on the screen, recording it if --cast was given.
+ * @param y The row to draw on.
+ * @param x The column to start drawing in.
+ * @param text The string to draw.
+ */
+void put_string(int y, int x, const std::string& text) {
+	mvaddstr(y, x, text.c_str());
+	if (recorder != nullptr) {
+		for (unsigned int i = 0; i < text.length() && x + (int) i < COLS; i++) {
+			recorder->cell(x + i, y, text[i], current_fg, current_bg);
+		}
+	}
+}
+
+/**
+ * Show everything drawn since the last call on the screen, ending a
+ * frame of the recording if --cast was given.
+ */
+void show() {
+	refresh();
+	if (recorder != nullptr) {
+		recorder->frame();
+	}
+}
 
 /**
  * Holds info on arguments passed from the CLI.
@@ -150,6 +137,15 @@ struct CliArgs {
 	bool sync_frame_rate;
 	bool enable_colors;
 	int esc_delay;
+	std::string save_path;
+	std::string resume_path;
+	int history;
+	int board_width;
+	int board_height;
+	std::string level_path;
+	std::string cast_path;
+	bool cast_compression;
+	int arena_bots;
 };
 
 /**
@@ -166,12 +162,31 @@ CliArgs parse_cli_args(int argc, char** argv) {
 	bool display_help = false;
 	bool enable_colors = true;
 
+	std::string save_path;
+	std::string resume_path;
+	long history = 10000;
+	int board_width = 0;
+	int board_height = 0;
+	bool invalid_board = false;
+	std::string level_path;
+	std::string cast_path;
+	bool cast_compression = false;
+	int arena_bots = 0;
+
 	std::string unknown_arg;
 
 	std::string esc_delay_prefix = "--esc_delay=";
 	std::string e_prefix = "-e";
+	std::string save_prefix = "--save=";
+	std::string resume_prefix = "--resume=";
+	std::string history_prefix = "--history=";
+	std::string board_prefix = "--board=";
+	std::string level_prefix = "--level=";
+	std::string cast_prefix = "--cast=";
+	std::string arena_prefix = "--arena=";
 
-	int hi = 0, di = 0, si = 0, ci = 0, ei = 0;
+	int hi = 0, di = 0, si = 0, ci = 0, ei = 0, vi = 0, ri = 0, ti = 0, bi = 0, li = 0, ai = 0,
+	        ni = 0;
 
 	for (int i = 1; i < argc; i++) {
 		std::string arg = argv[i];
@@ -210,6 +225,48 @@ CliArgs parse_cli_args(int argc, char** argv) {
 			esc_delay = atoi(substr.c_str());
 			ei++;
 		}
+		// next try save and resume
+		else if (arg.rfind(save_prefix, 0) == 0) {
+			save_path = arg.substr(save_prefix.length());
+			vi++;
+		} else if (arg.rfind(resume_prefix, 0) == 0) {
+			resume_path = arg.substr(resume_prefix.length());
+			ri++;
+		}
+		// next try history
+		else if (arg.rfind(history_prefix, 0) == 0) {
+			std::string substr = arg.substr(history_prefix.length());
+			history = atol(substr.c_str());
+			ti++;
+		}
+		// next try board
+		else if (arg.rfind(board_prefix, 0) == 0) {
+			std::string substr = arg.substr(board_prefix.length());
+			char trailing;
+			invalid_board = sscanf(substr.c_str(), "%dx%d%c", &board_width, &board_height,
+			        &trailing) != 2 || board_width < 1 || board_width > 100000
+			        || board_height < 1 || board_height > 100000
+			        || (long) board_width * board_height < 2;
+			bi++;
+		}
+		// next try level
+		else if (arg.rfind(level_prefix, 0) == 0) {
+			level_path = arg.substr(level_prefix.length());
+			li++;
+		}
+		// next try cast, compressed if the file ends in ".zst"
+		else if (arg.rfind(cast_prefix, 0) == 0) {
+			cast_path = arg.substr(cast_prefix.length());
+			cast_compression = cast_path.length() > 4
+			        && cast_path.compare(cast_path.length() - 4, 4, ".zst") == 0;
+			ai++;
+		}
+		// next try arena
+		else if (arg.rfind(arena_prefix, 0) == 0) {
+			std::string substr = arg.substr(arena_prefix.length());
+			arena_bots = atoi(substr.c_str());
+			ni++;
+		}
 		// else try optional flags
 		else if (std::regex_match(arg, std::regex("-[dhs]{1,2}"))) {
 			for (unsigned int i = 1; i < arg.length(); i++) {
@@ -237,10 +294,17 @@ CliArgs parse_cli_args(int argc, char** argv) {
 			break;
 		}
 	}
-	bool duplicate_args = hi > 1 || di > 1 || si > 1 || ci > 1 || ei > 1;
+	bool duplicate_args = hi > 1 || di > 1 || si > 1 || ci > 1 || ei > 1 || vi > 1 || ri > 1
+	        || ti > 1 || bi > 1 || li > 1 || ai > 1 || ni > 1;
+	bool board_and_level = bi > 0 && li > 0;
+	bool invalid_arena = ni > 0 && (arena_bots < 1 || arena_bots > ARENA_MAX_BOTS);
+	bool arena_conflict = ni > 0 && (vi > 0 || ri > 0 || ti > 0 || li > 0);
+	bool invalid_cast = ai > 0 && (cast_path.empty() || (cast_compression && !RECORDER_ZSTD));
 
 	// print usage info if inputs are invalid
-	if (display_help || unknown_arg.length() > 0 || duplicate_args || esc_delay < 100) {
+	if (display_help || unknown_arg.length() > 0 || duplicate_args || esc_delay < 100
+	        || history < 0 || history > HISTORY_MAX_TICKS || invalid_board || board_and_level
+	        || invalid_cast || invalid_arena || arena_conflict) {
 		if (display_help) {
 			std::cout << "Help info:" << std::endl;
 		} else if (unknown_arg.length() > 0) {
@@ -251,17 +315,50 @@ CliArgs parse_cli_args(int argc, char** argv) {
 			std::cout << "Too many arguments." << std::endl;
 		} else if (esc_delay < 100) {
 			std::cout << "esc_delay of " << esc_delay << " is too small." << std::endl;
+		} else if (history < 0) {
+			std::cout << "history of " << history << " is negative." << std::endl;
+		} else if (history > HISTORY_MAX_TICKS) {
+			std::cout << "history of " << history << " is more than " << HISTORY_MAX_TICKS << "."
+			          << std::endl;
+		} else if (invalid_board) {
+			std::cout << "Invalid board size." << std::endl;
+		} else if (board_and_level) {
+			std::cout << "A level sets its own board size, so --board and --level can't be "
+			          << "combined." << std::endl;
+		} else if (invalid_cast) {
+			std::cout << (cast_path.empty() ? "Missing --cast file." :
+			        "This build can't compress recordings; build with -DSNAKEGAME_ZSTD -lzstd.")
+			          << std::endl;
+		} else if (invalid_arena) {
+			std::cout << "An arena needs between 1 and " << ARENA_MAX_BOTS << " bots." << std::endl;
+		} else if (arena_conflict) {
+			std::cout << "--arena can't be combined with --save, --resume, --history or --level."
+			          << std::endl;
 		}
 		std::cout << std::endl;
-		std::cout << "Usage: SnakeGame [ {easy|normal|hard} -dhs -eMilliseconds ]" << std::endl;
+		std::cout << "Usage: SnakeGame [ {easy|normal|hard} -dhs -eMilliseconds --save=file "
+		          << "--resume=file --history=ticks --board=WIDTHxHEIGHT --level=file --cast=file "
+		          << "--arena=bots ]" << std::endl;
 		std::cout << std::endl;
 		std::cout << "Difficulty setting defaults to \"normal\"." << std::endl;
 		std::cout << std::endl;
 		std::cout << "Options:" << std::endl;
+		std::cout << "\"--arena=bots\" plays against up to " << ARENA_MAX_BOTS
+		          << " bot snakes on one board." << std::endl;
+		std::cout << "\"--board=WIDTHxHEIGHT\" sets the board size, from 2 cells up to "
+		          << "100000x100000, defaults to the terminal size." << std::endl;
+		std::cout << "\"--cast=file\" records the session in asciicast v2 format, zstd compressed "
+		          << "if file ends in .zst." << std::endl;
 		std::cout << "\"--disable_colors\" (-d) disables color output." << std::endl;
 		std::cout << "\"--esc_delay=milliseconds\" (-eMilliseconds) defaults to 100, and must be >="
 		          << "100." << std::endl;
 		std::cout << "\"--help\" (-h) displays this help info." << std::endl;
+		std::cout << "\"--history=ticks\" sets how many ticks can be rewound, up to "
+		          << HISTORY_MAX_TICKS << ", defaults to 10000." << std::endl;
+		std::cout << "\"--level=file\" plays on a level compiled with LevelCompiler." << std::endl;
+		std::cout << "\"--resume=file\" resumes a game saved with --save, starting paused."
+		          << std::endl;
+		std::cout << "\"--save=file\" saves the game to file when quitting." << std::endl;
 		std::cout << "\"--sync_frame_rate\" (-s) synchronizes horizontal and vertical frame rates."
 		          << std::endl;
 		std::cout << std::endl;
@@ -272,236 +369,678 @@ CliArgs parse_cli_args(int argc, char** argv) {
 		          << "larger esc_delay." << std::endl;
 		exit(0);
 	}
-	CliArgs cli_args = { difficulty, sync_frame_rate, enable_colors, esc_delay };
+	CliArgs cli_args = { difficulty, sync_frame_rate, enable_colors, esc_delay, save_path,
+	        resume_path, (int) history, board_width, board_height, level_path, cast_path,
+	        cast_compression, arena_bots };
 	return cli_args;
 }
 
 /**
- * Run the game.
- * @param argc The argument count.
- * @param argv The argument values.
+ * Fill the given area of the screen with blank cells.
+ * @param width The width of the area to clear.
+ * @param height The height of the area to clear.
  */
+void clear_screen(int width, int height) {
+	set_color(BLACK);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			put_char(y, x, ' ');
+		}
+	}
+}
 
-void snake_game(int argc, char** argv) {
-	CliArgs cli_args = parse_cli_args(argc, argv);
-
-	Difficulty difficulty = cli_args.difficulty;
-	bool sync_frame_rate = cli_args.sync_frame_rate;
-	bool enable_colors = cli_args.enable_colors;
-	int esc_delay = cli_args.esc_delay;
-
-	long sleep_ms_horizontal;
-	long sleep_ms_vertical;
-
-	if (difficulty == Difficulty::EASY) {
-		sleep_ms_horizontal = 66 * 1000;
-		sleep_ms_vertical = 110 * 1000;
-	} else if (difficulty == Difficulty::NORMAL) {
-		sleep_ms_horizontal = 44 * 1000;
-		sleep_ms_vertical = 77 * 1000;
-	} else if (difficulty == Difficulty::HARD) {
-		sleep_ms_horizontal = 22 * 1000;
-		sleep_ms_vertical = 34 * 1000;
-	} else {
-		// unreachable code
-		std::cout << "Unexpected error, difficulty = UNDEFINED." << std::endl;
-		std::cout << "Exiting SnakeGame." << std::endl;
-		exit(0);
+/**
+ * Get the name of a Difficulty, as typed on the command line.
+ * @param difficulty The Difficulty to get the name of.
+ * @return The name of the Difficulty.
+ */
+std::string difficulty_name(Difficulty difficulty) {
+	switch (difficulty) {
+	case Difficulty::EASY:
+		return "easy";
+	case Difficulty::HARD:
+		return "hard";
+	default:
+		return "normal";
 	}
+}
 
-	if (sync_frame_rate) {
-		sleep_ms_horizontal = sleep_ms_vertical;
+/**
+ * Display the best recorded scores below an end screen, as many as fit.
+ * @param gy The line to start drawing on.
+ * @param difficulty The Difficulty the scores were recorded at.
+ * @param top The best scores, best first.
+ * @param current The record of the game that just ended, to highlight,
+ *        or nullptr if it was not recorded.
+ */
+void draw_high_scores(int gy, Difficulty difficulty, std::vector<ScoreRecord>* top,
+        ScoreRecord* current) {
+	if (top->empty()) {
+		return;
+	}
+	int width = COLS;
+	std::string title = "High Scores (" + difficulty_name(difficulty) + ")";
+	set_color(WHITE);
+	put_string(gy, width / 2 - title.length() / 2, title);
+
+	bool highlighted = false;
+	for (unsigned int i = 0; i < top->size() && ++gy < LINES; i++) {
+		ScoreRecord& r = (*top)[i];
+		char line[64];
+		snprintf(line, sizeof(line), "%2u. %6d  %dx%d", i + 1, r.score, r.width, r.height);
+		bool is_current = current != nullptr && !highlighted && r.score == current->score
+		        && r.timestamp == current->timestamp && r.duration_ms == current->duration_ms;
+		highlighted = highlighted || is_current;
+		set_color(is_current ? GREEN : WHITE);
+		put_string(gy, width / 2 - title.length() / 2, line);
 	}
+}
 
-	initscr();
-	cbreak();
-	noecho();
-	curs_set(0);
-	keypad(stdscr, TRUE);
-	ESCDELAY = esc_delay;
+/**
+ * Display the game over screen.
+ * @param game The Game that just ended.
+ * @param top The best recorded scores, best first.
+ * @param current The record of this game, or nullptr if it was not recorded.
+ */
+void draw_game_over(Game* game, std::vector<ScoreRecord>* top, ScoreRecord* current) {
+	int width = COLS;
+	int height = LINES;
+	clear_screen(width, height);
 
-	if (enable_colors) {
-		init_colors();
-	}
+	std::string game_over_text = "Game Over";
+	int len = game_over_text.length();
+	int gx = width / 2 - len / 2;
+	int gy = height / 2;
+
+	set_color(RED);
+	put_string(gy, gx, game_over_text);
+
+	int score = game->snake->segment_count;
+	std::string score_key = "Score: ";
+	std::string score_value = std::to_string(score);
+	len = score_key.length() + score_value.length();
+	gx = width / 2 - len / 2;
+	gy += 1;
+
+	set_color(WHITE);
+	put_string(gy, gx, score_key);
 
+	set_color(YELLOW);
+	put_string(gy, gx + score_key.length(), score_value);
+
+	draw_high_scores(gy + 2, game->difficulty, top, current);
+	show();
+}
+
+/**
+ * Display the victory screen.
+ * @param game The Game that was just won.
+ * @param top The best recorded scores, best first.
+ * @param current The record of this game, or nullptr if it was not recorded.
+ */
+void draw_victory(Game* game, std::vector<ScoreRecord>* top, ScoreRecord* current) {
 	int width = COLS;
 	int height = LINES;
+	clear_screen(width, height);
 
-	// init the background color
-	attron(COLOR_PAIR(BLACK));
-	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-			mvaddch(y, x, ' ');
-		}
-	}
+	std::string victory_text = "Congratulations,";
+	int len = victory_text.length();
+	int gx = width / 2 - len / 2;
+	int gy = height / 2 - 1;
 
-	// initialize RNG
-	random_engine.seed(time(0));
-	width_dist = std::uniform_int_distribution<int>(0, width - 1);
-	height_dist = std::uniform_int_distribution<int>(0, height - 1);
+	set_color(WHITE);
+	put_string(gy, gx, victory_text);
 
-	// initialize the Snake
-	Snake* snake = new Snake();
-	snake->direction = Direction::RIGHT;
-	Point* start = new Point(width / 2, height / 2);
-	snake->grow(start);
-
-	// generate first treasure
-	Point* treasure;
-	bool generate_treasure = true;
-	while (generate_treasure) {
-		treasure = get_random_point();
-		generate_treasure = snake->contains(treasure);
-		if (generate_treasure) {
-			delete treasure;
-		}
-	}
-	attron(COLOR_PAIR(YELLOW));
-	mvaddch(treasure->y, treasure->x, '$');
-	attron(COLOR_PAIR(GREEN));
-	mvaddch(snake->head->y(), snake->head->x(), '@');
-	refresh();
+	victory_text = "you win!";
+	len = victory_text.length();
+	gx = width / 2 - len / 2;
+	gy += 1;
 
-	// read user input on a separate thread.
-	pthread_t read_input_thread;
-	pthread_create(&read_input_thread, nullptr, read_user_input, (void*) snake);
+	put_string(gy, gx, victory_text);
 
-	// game loop
-	while (true) {
+	int score = game->snake->segment_count;
+	std::string score_key = "Maximum Score: ";
+	std::string score_value = std::to_string(score);
+	len = score_key.length() + score_value.length();
+	gx = width / 2 - len / 2;
+	gy += 1;
 
-		// sleep to control frame rate
-		if (snake->direction == Direction::LEFT || snake->direction == Direction::RIGHT) {
-			usleep(sleep_ms_horizontal);
-		} else {
-			usleep(sleep_ms_vertical);
-		}
-		if (snake->pause) {
-			continue;
-		}
+	put_string(gy, gx, score_key);
 
-		Point* next_move = snake->get_next_move();
+	set_color(GREEN);
+	put_string(gy, gx + score_key.length(), score_value);
 
-		// check for game over conditions
-		bool out_of_bounds = next_move->x < 0 || next_move->x >= width || next_move->y < 0
-		        || next_move->y >= height;
+	draw_high_scores(gy + 2, game->difficulty, top, current);
+	show();
+}
 
-		bool snake_collision = snake->contains(next_move);
+/**
+ * The window of the board currently shown on the screen.
+ */
+struct Viewport {
+	int x = 0;      // board coordinates of the top-left screen cell
+	int y = 0;
+	int width = 0;  // size of the screen
+	int height = 0;
+};
 
-		// display game over screen
-		if (out_of_bounds || snake_collision) {
-			// clear the screen
-			attron(COLOR_PAIR(BLACK));
-			for (int y = 0; y < height; y++) {
-				for (int x = 0; x < width; x++) {
-					mvaddch(y, x, ' ');
-				}
+/**
+ * Draw a single board cell, if it is currently visible.
+ * @param view The Viewport showing the board.
+ * @param x The x coordinate of the cell on the board.
+ * @param y The y coordinate of the cell on the board.
+ * @param c The character to draw.
+ */
+void draw_cell(Viewport* view, int x, int y, char c) {
+	int sx = x - view->x;
+	int sy = y - view->y;
+	if (sx >= 0 && sx < view->width && sy >= 0 && sy < view->height) {
+		put_char(sy, sx, c);
+	}
+}
+
+/**
+ * Draw every visible cell of the board. Off-board cells are drawn as
+ * walls, like the Level's walls. ncurses only sends the cells that
+ * actually changed.
+ * @param game The Game to draw.
+ * @param view The Viewport showing the board.
+ */
+void draw_board(Game* game, Viewport* view) {
+	for (int sy = 0; sy < view->height; sy++) {
+		for (int sx = 0; sx < view->width; sx++) {
+			int x = sx + view->x;
+			int y = sy + view->y;
+			if (x >= game->width || y >= game->height
+			        || (game->level != nullptr && game->level->wall(x, y))) {
+				set_color(GRAY);
+				put_char(sy, sx, '#');
+			} else if (game->snake->contains(x, y)) {
+				set_color(GREEN);
+				put_char(sy, sx, '@');
+			} else if (x == game->treasure.x && y == game->treasure.y) {
+				set_color(YELLOW);
+				put_char(sy, sx, '$');
+			} else {
+				set_color(BLACK);
+				put_char(sy, sx, ' ');
 			}
-			std::string game_over_text = "Game Over";
-			int len = game_over_text.length();
-			int gx = width / 2 - len / 2;
-			int gy = height / 2;
+		}
+	}
+	show();
+}
+
+/**
+ * Get the offset along one axis at which the Viewport should show the head.
+ * The offset only changes once the head comes within a quarter of the
+ * screen of an edge, and then jumps to center the head.
+ * @param head The head's coordinate on this axis.
+ * @param offset The Viewport's current offset on this axis.
+ * @param view_size The size of the screen on this axis.
+ * @param board_size The size of the board on this axis.
+ * @return The new offset.
+ */
+int scroll_offset(int head, int offset, int view_size, int board_size) {
+	if (board_size <= view_size) {
+		return 0;
+	}
+	int margin = view_size / 4;
+	if (head - offset >= margin && head - offset < view_size - margin) {
+		return offset;
+	}
+	int centered = head - view_size / 2;
+	return std::max(0, std::min(centered, board_size - view_size));
+}
+
+/**
+ * Scroll the Viewport to follow the Snake's head, redrawing the
+ * board if it moved.
+ * @param game The Game being shown.
+ * @param view The Viewport showing the board.
+ */
+void follow_head(Game* game, Viewport* view) {
+	Point head = game->snake->head();
+	int x = scroll_offset(head.x, view->x, view->width, game->width);
+	int y = scroll_offset(head.y, view->y, view->height, game->height);
+	if (x != view->x || y != view->y) {
+		view->x = x;
+		view->y = y;
+		draw_board(game, view);
+	}
+}
 
-			attron(COLOR_PAIR(RED));
-			mvaddstr(gy, gx, game_over_text.c_str());
+/**
+ * Step the Game one tick backwards or forwards through its History,
+ * pausing it and redrawing only the cells that changed.
+ * @param game The Game to step.
+ * @param view The Viewport showing the board.
+ * @param history The History of the Game.
+ * @param backwards true to rewind, false to fast-forward.
+ */
+void step_history(Game* game, Viewport* view, History* history, bool backwards) {
+	game->snake->pause = true;
 
-			int score = snake->segment_count;
-			std::string score_key = "Score: ";
-			std::string score_value = std::to_string(score);
-			len = score_key.length() + score_value.length();
-			gx = width / 2 - len / 2;
-			gy += 1;
+	TickDelta delta;
+	if (backwards) {
+		if (!history->rewind(game, &delta)) {
+			return;
+		}
+		set_color(GREEN);
+		draw_cell(view, delta.head_x, delta.head_y, ' ');
+		if (delta.grew()) {
+			draw_cell(view, delta.new_treasure_x, delta.new_treasure_y, ' ');
+			set_color(YELLOW);
+			draw_cell(view, delta.old_treasure_x, delta.old_treasure_y, '$');
+		} else {
+			draw_cell(view, delta.tail_x, delta.tail_y, '@');
+		}
+	} else {
+		if (!history->forward(game, &delta)) {
+			return;
+		}
+		if (delta.grew()) {
+			set_color(YELLOW);
+			draw_cell(view, delta.new_treasure_x, delta.new_treasure_y, '$');
+		} else {
+			draw_cell(view, delta.tail_x, delta.tail_y, ' ');
+		}
+		set_color(GREEN);
+		draw_cell(view, delta.head_x, delta.head_y, '@');
+	}
+	show();
+	follow_head(game, view);
+}
 
-			attron(COLOR_PAIR(WHITE));
-			move(gy, gx);
-			addstr(score_key.c_str());
+/**
+ * Stop recording, if --cast was given, and report how it went.
+ * Call after endwin().
+ */
+void finish_recording() {
+	if (recorder != nullptr) {
+		recorder->stop();
+		std::cout << recorder->report() << std::endl;
+		delete recorder;
+		recorder = nullptr;
+	}
+}
 
-			attron(COLOR_PAIR(YELLOW));
-			addstr(score_value.c_str());
+/**
+ * Get the Direction a movement key turns to.
+ * @param input The key code, as returned by getch().
+ * @param direction Set to the Direction, if input is a movement key.
+ * @return true if input is a movement key, else false.
+ */
+bool key_direction(int input, Direction* direction) {
+	switch (input) {
+	case A_KEY_A:
+	case A_KEY_H:
+	case A_KEY_LEFT:
+	case KEY_LEFT:
+		*direction = Direction::LEFT;
+		return true;
+	case A_KEY_S:
+	case A_KEY_J:
+	case A_KEY_DOWN:
+	case KEY_DOWN:
+		*direction = Direction::DOWN;
+		return true;
+	case A_KEY_W:
+	case A_KEY_K:
+	case A_KEY_UP:
+	case KEY_UP:
+		*direction = Direction::UP;
+		return true;
+	case A_KEY_D:
+	case A_KEY_L:
+	case A_KEY_RIGHT:
+	case KEY_RIGHT:
+		*direction = Direction::RIGHT;
+		return true;
+	}
+	return false;
+}
 
-			refresh();
+/**
+ * Apply a single key press to the Game.
+ * @param game The Game being played.
+ * @param input The key code, as returned by getch().
+ */
+void handle_input(Game* game, int input) {
+	Direction direction;
+	if (key_direction(input, &direction)) {
+		game->turn(direction);
+		return;
+	}
+	switch (input) {
+	case A_KEY_P:
+	case A_KEY_SPACE:
+		game->toggle_pause();
+		break;
+	case A_KEY_Q:
+	case A_KEY_ESCAPE:
+		game->quit = true;
+		break;
+	}
+}
 
-			snake->game_over = true;
-			pthread_join(read_input_thread, nullptr);
+/**
+ * Get the current time of the monotonic clock.
+ * @return The current time, in microseconds.
+ */
+long now_us() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-			endwin();
-			exit(0);
+/**
+ * Draw the visible cells of an Arena that changed since the last call.
+ * Off-board cells are drawn as walls, the player's Snake as '@' and the
+ * bots as 'o'.
+ * @param arena The Arena to draw.
+ * @param view The Viewport showing the board.
+ * @param shown What each screen cell shows, updated as cells are drawn.
+ */
+void draw_arena(Arena* arena, Viewport* view, std::vector<char>* shown) {
+	std::vector<char> frame(view->width * view->height, ' ');
+	for (int sy = 0; sy < view->height; sy++) {
+		for (int sx = 0; sx < view->width; sx++) {
+			int x = sx + view->x;
+			int y = sy + view->y;
+			if (x >= arena->width || y >= arena->height) {
+				frame[sy * view->width + sx] = '#';
+			} else if (arena->occupied.get(x, y)) {
+				frame[sy * view->width + sx] = 'o';
+			}
+		}
+	}
+	for (Point& t : arena->treasures) {
+		if (t.x < 0) {
+			continue;
+		}
+		int sx = t.x - view->x;
+		int sy = t.y - view->y;
+		if (sx >= 0 && sx < view->width && sy >= 0 && sy < view->height) {
+			frame[sy * view->width + sx] = '$';
+		}
+	}
+	Snake* player = arena->snakes[0];
+	for (int i = 0; player != nullptr && i < player->segment_count; i++) {
+		Point p = player->segment(i);
+		int sx = p.x - view->x;
+		int sy = p.y - view->y;
+		if (sx >= 0 && sx < view->width && sy >= 0 && sy < view->height) {
+			frame[sy * view->width + sx] = '@';
 		}
+	}
 
-		// check for collision with treasure
-		if (next_move->equals(treasure)) {
-			snake->grow(next_move);
+	for (int i = 0; i < view->width * view->height; i++) {
+		char c = frame[i];
+		if (c == (*shown)[i]) {
+			continue;
+		}
+		switch (c) {
+		case '#':
+			set_color(GRAY);
+			break;
+		case 'o':
+			set_color(BLUE);
+			break;
+		case '@':
+			set_color(GREEN);
+			break;
+		case '$':
+			set_color(YELLOW);
+			break;
+		default:
+			set_color(BLACK);
+			break;
+		}
+		put_char(i / view->width, i % view->width, c);
+		(*shown)[i] = c;
+	}
+	show();
+}
 
-			// check for victory condition
-			int max_length = width * height;
-			if (snake->segment_count == max_length) {
-				// clear the screen
-				attron(COLOR_PAIR(BLACK));
-				for (int y = 0; y < height; y++) {
-					for (int x = 0; x < width; x++) {
-						mvaddch(y, x, ' ');
-					}
+/**
+ * Play against bot Snakes in an Arena until the player quits. The
+ * player's Snake respawns when it dies, like the bots.
+ * @param cli_args The CLI arguments.
+ * @param width The width of the board.
+ * @param height The height of the board.
+ */
+void play_arena(CliArgs* cli_args, int width, int height) {
+	int snakes = cli_args->arena_bots + 1;
+	int threads = std::min(std::max(1u, std::thread::hardware_concurrency()),
+	        1u + snakes / 2000);
+	Arena arena(width, height, snakes, snakes / 2 + 1, threads, time(0));
+	arena.players = 1;
+
+	// center the Viewport on the player
+	Viewport view;
+	view.width = COLS;
+	view.height = LINES;
+	Point head = arena.snakes[0] != nullptr ? arena.snakes[0]->head() : Point(0, 0);
+	view.x = scroll_offset(head.x, -COLS, COLS, width);
+	view.y = scroll_offset(head.y, -LINES, LINES, height);
+	std::vector<char> shown(view.width * view.height, 0);
+	draw_arena(&arena, &view, &shown);
+
+	// start paused, so the player can find their Snake
+	bool pause = true;
+	bool quit = false;
+	int best = 1;
+	Direction heading = arena.snakes[0] != nullptr ? arena.snakes[0]->direction : Direction::RIGHT;
+	long next_tick = now_us();
+	while (!quit) {
+		long remaining = next_tick - now_us();
+		if (remaining > 0 || pause) {
+			timeout(pause ? -1 : (remaining + 999) / 1000);
+			int input = getch();
+			Direction direction;
+			if (key_direction(input, &direction)) {
+				arena.turn(0, direction);
+				if (pause) {
+					pause = false;
+					next_tick = now_us();
 				}
-				std::string victory_text = "Congratulations,";
-				int len = victory_text.length();
-				int gx = width / 2 - len / 2;
-				int gy = height / 2 - 1;
+			} else if (input == A_KEY_P || input == A_KEY_SPACE) {
+				pause = !pause;
+				next_tick = now_us();
+			} else if (input == A_KEY_Q || input == A_KEY_ESCAPE) {
+				quit = true;
+			}
+			continue;
+		}
 
-				attron(COLOR_PAIR(WHITE));
-				mvaddstr(gy, gx, victory_text.c_str());
+		arena.tick();
+		Snake* player = arena.snakes[0];
+		if (player != nullptr) {
+			best = std::max(best, player->segment_count);
+			heading = player->direction;
+			head = player->head();
+			view.x = scroll_offset(head.x, view.x, view.width, width);
+			view.y = scroll_offset(head.y, view.y, view.height, height);
+		}
+		next_tick += tick_interval(cli_args->difficulty, cli_args->sync_frame_rate, heading);
+		draw_arena(&arena, &view, &shown);
+	}
+	endwin();
+	finish_recording();
+	std::cout << "Arena with " << cli_args->arena_bots << " bots: your longest snake was " << best
+	          << ", and you died " << arena.player_deaths << " times in " << arena.tick_count
+	          << " ticks." << std::endl;
+}
 
-				victory_text = "you win!";
-				len = victory_text.length();
-				gx = width / 2 - len / 2;
-				gy += 1;
+/**
+ * Run the game.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ */
+void snake_game(int argc, char** argv) {
+	CliArgs cli_args = parse_cli_args(argc, argv);
 
-				mvaddstr(gy, gx, victory_text.c_str());
+	Level* level = nullptr;
+	if (cli_args.level_path.length() > 0) {
+		level = load_level(cli_args.level_path);
+		if (level == nullptr) {
+			std::cout << "Unable to load the level \"" << cli_args.level_path << "\"." << std::endl;
+			exit(0);
+		}
+	}
 
-				int score = snake->segment_count;
-				std::string score_key = "Maximum Score: ";
-				std::string score_value = std::to_string(score);
-				len = score_key.length() + score_value.length();
-				gx = width / 2 - len / 2;
-				gy += 1;
+	Game* game = nullptr;
+	if (cli_args.resume_path.length() > 0) {
+		std::string error;
+		game = load_snapshot(cli_args.resume_path, level, &error);
+		if (game == nullptr) {
+			std::cout << "Unable to resume from \"" << cli_args.resume_path << "\". " << error
+			          << std::endl;
+			exit(0);
+		}
+		game->snake->pause = true;
+	}
 
-				move(gy, gx);
-				addstr(score_key.c_str());
+	initscr();
+	cbreak();
+	noecho();
+	curs_set(0);
+	keypad(stdscr, TRUE);
+	ESCDELAY = cli_args.esc_delay;
 
-				attron(COLOR_PAIR(GREEN));
-				addstr(score_value.c_str());
+	if (cli_args.enable_colors) {
+		init_colors();
+	}
 
-				refresh();
+	if (cli_args.cast_path.length() > 0) {
+		recorder = new Recorder(cli_args.cast_path, COLS, LINES, cli_args.cast_compression);
+		if (!recorder->start()) {
+			endwin();
+			std::cout << "Unable to record to \"" << cli_args.cast_path << "\"." << std::endl;
+			exit(0);
+		}
+	}
 
-				snake->game_over = true;
-				pthread_join(read_input_thread, nullptr);
+	int width = cli_args.board_width > 0 ? cli_args.board_width : COLS;
+	int height = cli_args.board_height > 0 ? cli_args.board_height : LINES;
 
-				endwin();
-				exit(0);
+	if (cli_args.arena_bots > 0) {
+		if ((long) width * height < (long) ARENA_CELLS_PER_SNAKE * (cli_args.arena_bots + 1)) {
+			endwin();
+			finish_recording();
+			std::cout << "The board is too small for " << cli_args.arena_bots << " bots."
+			          << std::endl;
+			exit(0);
+		}
+		play_arena(&cli_args, width, height);
+		return;
+	}
+
+	if (game == nullptr) {
+		if (level != nullptr) {
+			game = new Game(level, time(0));
+		} else {
+			game = new Game(width, height, time(0));
+		}
+		game->difficulty = cli_args.difficulty;
+		game->sync_frame_rate = cli_args.sync_frame_rate;
+	}
+	Snake* snake = game->snake;
+	History history(cli_args.history);
+
+	// center the Viewport on the Snake
+	Viewport view;
+	view.width = COLS;
+	view.height = LINES;
+	view.x = scroll_offset(snake->head().x, -COLS, COLS, game->width);
+	view.y = scroll_offset(snake->head().y, -LINES, LINES, game->height);
+	draw_board(game, &view);
+
+	std::string leaderboard_dir = default_leaderboard_dir();
+	bool recorded = false;
+	long start_time = now_us();
+
+	// game loop: wait for input until the next tick is due, so that
+	// key presses are handled on this thread without blocking the frame rate.
+	long next_tick = now_us() + game->tick_interval();
+	while (!game->quit) {
+		long remaining = next_tick - now_us();
+		if (remaining > 0) {
+			timeout((remaining + 999) / 1000);
+			int input = getch();
+			if (input == A_KEY_R || input == A_KEY_F) {
+				step_history(game, &view, &history, input == A_KEY_R);
+			} else if (input != ERR) {
+				handle_input(game, input);
 			}
+			continue;
+		}
 
-			// generate new treasure
-			generate_treasure = true;
-			while (generate_treasure) {
-				treasure = get_random_point();
-				generate_treasure = snake->contains(treasure);
-				if (generate_treasure) {
-					delete treasure;
+		TickResult result = game->tick();
+		next_tick += game->tick_interval();
+		history.record(game, result);
+
+		if (result == TickResult::GAME_OVER || result == TickResult::VICTORY) {
+			// record the first ending only, not replays after a rewind
+			std::vector<ScoreRecord> top;
+			ScoreRecord record;
+			ScoreRecord* current = nullptr;
+			if (leaderboard_dir.length() > 0) {
+				Leaderboard leaderboard(leaderboard_dir);
+				if (!recorded) {
+					record = make_score_record(game, (now_us() - start_time) / 1000);
+					if (leaderboard.record(record)) {
+						current = &record;
+					}
+					recorded = true;
 				}
+				uint64_t games;
+				top = leaderboard.top(game->difficulty, &games);
 			}
+			if (result == TickResult::GAME_OVER) {
+				draw_game_over(game, &top, current);
+			} else {
+				draw_victory(game, &top, current);
+			}
+			// wait for any key before leaving the final screen,
+			// or go back to the board to rewind the lost run
+			timeout(-1);
+			int input = getch();
+			if (result == TickResult::GAME_OVER && input == A_KEY_R) {
+				snake->game_over = false;
+				snake->pause = true;
+				draw_board(game, &view);
+				next_tick = now_us() + game->tick_interval();
+				continue;
+			}
+			break;
+		}
+
+		if (result == TickResult::ATE) {
 			// draw new treasure
-			attron(COLOR_PAIR(YELLOW));
-			mvaddch(treasure->y, treasure->x, '$');
-		} else {
-			// un-draw last Segment of Snake
-			mvaddch(snake->tail->y(), snake->tail->x(), ' ');
-			snake->move(next_move);
+			set_color(YELLOW);
+			draw_cell(&view, game->treasure.x, game->treasure.y, '$');
+		} else if (result == TickResult::MOVED) {
+			// un-draw last cell of Snake
+			draw_cell(&view, game->vacated.x, game->vacated.y, ' ');
 		}
-		// draw next Segment of Snake
-		attron(COLOR_PAIR(GREEN));
-		mvaddch(snake->head->y(), snake->head->x(), '@');
-		refresh();
+		// draw next cell of Snake
+		set_color(GREEN);
+		draw_cell(&view, snake->head().x, snake->head().y, '@');
+		show();
+		follow_head(game, &view);
 	}
-	// unreachable, but included for posterity
 	endwin();
+
+	finish_recording();
+	if (game->quit && cli_args.save_path.length() > 0) {
+		if (save_snapshot(game, cli_args.save_path)) {
+			std::cout << "Game saved to \"" << cli_args.save_path << "\"." << std::endl;
+		} else {
+			std::cout << "Unable to save to \"" << cli_args.save_path << "\"." << std::endl;
+		}
+	}
+	delete game;
+	delete level;
 }
 
 /**
@@ -512,35 +1051,36 @@ void print_fields(Snake* snake) {
 	std::cout << "Snake:" << std::endl;
 	std::cout << "-------" << std::endl;
 	std::cout << "direction: " << ENUM_CAST(snake->direction) << std::endl;
-	std::cout << "head: " << snake->head->to_string() << std::endl;
-	std::cout << "tail: " << snake->tail->to_string() << std::endl;
+	std::cout << "head: " << snake->head().to_string() << std::endl;
+	std::cout << "tail: " << snake->tail().to_string() << std::endl;
 	std::cout << "segment_count: " << snake->segment_count << std::endl;
+	std::cout << "capacity: " << snake->body.size() << std::endl;
 
-	for (Segment* s = snake->head; s != nullptr; s = s->next) {
-		std::cout << "    segment: " << s->to_string() << std::endl;
+	for (int i = 0; i < snake->segment_count; i++) {
+		std::cout << "    segment: " << snake->segment(i).to_string() << std::endl;
 	}
 	std::cout << std::endl;
 }
 
 /**
- * Test function to verify the accurateness of Snake and Segment's
- * linked-list functionality.
+ * Test function to verify the accurateness of the Snake's
+ * ring buffer functionality.
  */
 void test_snake_segments() {
 	Snake* snake = new Snake();
-	Point* start_pos = new Point(1, 1);
-	snake->grow(start_pos);
+	snake->grow(Point(1, 1));
 	print_fields(snake);
 
-	snake->grow(new Point(1, 2));
+	snake->grow(Point(1, 2));
 	print_fields(snake);
 
-	snake->grow(new Point(1, 3));
-	snake->grow(new Point(1, 4));
+	snake->grow(Point(1, 3));
+	snake->grow(Point(1, 4));
 	print_fields(snake);
 
-	snake->move(new Point(2, 4));
+	snake->move(Point(2, 4));
 	print_fields(snake);
+	delete snake;
 }
 
 /**
@@ -0,0 +1,248 @@
+/*
+ * Snapshot.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Snapshot.h"
+
+/**
+ * Round a byte count up to the next multiple of 4,
+ * so the body that follows stays aligned for int32_t access.
+ * @param n The byte count.
+ * @return n rounded up to a multiple of 4.
+ */
+static size_t align4(size_t n) {
+	return (n + 3) & ~(size_t) 3;
+}
+
+/**
+ * Serialize the complete state of a Game.
+ * @param game The Game to serialize.
+ * @return The snapshot bytes.
+ */
+std::string encode_snapshot(Game* game) {
+	Snake* snake = game->snake;
+
+	std::ostringstream rng;
+	rng << game->random_engine;
+	std::string rng_state = rng.str();
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.width = game->width;
+	header.height = game->height;
+	header.difficulty = (uint8_t) game->difficulty;
+	header.sync_frame_rate = game->sync_frame_rate;
+	header.direction = (uint8_t) snake->direction;
+	header.pause = snake->pause;
+	header.treasure_x = game->treasure.x;
+	header.treasure_y = game->treasure.y;
+	header.rng_length = rng_state.length();
+	header.segment_count = snake->segment_count;
+	if (game->level != nullptr) {
+		header.has_level = 1;
+		header.level_checksum = game->level->checksum;
+	}
+
+	size_t body_offset = sizeof(header) + align4(rng_state.length());
+	std::string data(body_offset + snake->segment_count * 2 * sizeof(int32_t), '\0');
+	memcpy(&data[0], &header, sizeof(header));
+	memcpy(&data[sizeof(header)], rng_state.data(), rng_state.length());
+
+	// the ring wraps at most once, so the body is one or two runs
+	Point* body = (Point*) &data[body_offset];
+	size_t first = std::min((size_t) snake->segment_count, snake->body.size() - snake->head_index);
+	memcpy(body, &snake->body[snake->head_index], first * sizeof(Point));
+	memcpy(body + first, &snake->body[0], (snake->segment_count - first) * sizeof(Point));
+	return data;
+}
+
+/**
+ * Rebuild a Game from snapshot bytes.
+ * @param data The snapshot bytes.
+ * @param size The number of bytes available at data.
+ * @param level The Level to play on, which must be the one the game was
+ *        saved on, or nullptr if it was saved without a Level.
+ * @param error Set to a description of the problem if decoding fails.
+ * @return The restored Game, or nullptr if the data is not a valid snapshot.
+ */
+Game* decode_snapshot(const char* data, size_t size, Level* level, std::string* error) {
+	*error = "The file is not a valid snapshot.";
+	SnapshotHeader header;
+	if (size < sizeof(header)) {
+		return nullptr;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+		return nullptr;
+	}
+	if (header.width <= 0 || header.height <= 0 || header.segment_count <= 0
+	        || header.difficulty > (uint8_t) Difficulty::HARD
+	        || header.direction > (uint8_t) Direction::RIGHT) {
+		return nullptr;
+	}
+	size_t body_offset = sizeof(header) + align4(header.rng_length);
+	size_t body_size = (size_t) header.segment_count * 2 * sizeof(int32_t);
+	if (header.rng_length > size || body_offset + body_size != size) {
+		return nullptr;
+	}
+
+	// the game must resume on the Level it was saved on, if any
+	if (header.has_level && level == nullptr) {
+		*error = "The game was saved on a level, so it must be resumed with that --level.";
+		return nullptr;
+	}
+	if (!header.has_level && level != nullptr) {
+		*error = "The game was saved without a level, so it can't be resumed with --level.";
+		return nullptr;
+	}
+	if (level != nullptr && (level->width != header.width || level->height != header.height
+	        || level->checksum != header.level_checksum)) {
+		*error = "The game was saved on a different level.";
+		return nullptr;
+	}
+
+	// check each cell of the body is open and adjacent to the one
+	// before it, before marking any of them
+	const Point* cells = (const Point*) (data + body_offset);
+	for (int i = 0; i < header.segment_count; i++) {
+		Point p = cells[i];
+		if (p.x < 0 || p.x >= header.width || p.y < 0 || p.y >= header.height
+		        || (level != nullptr && level->wall(p.x, p.y))) {
+			return nullptr;
+		}
+		if (i > 0 && abs(p.x - cells[i - 1].x) + abs(p.y - cells[i - 1].y) != 1) {
+			return nullptr;
+		}
+	}
+
+	Game* game = new Game();
+	game->width = header.width;
+	game->height = header.height;
+	game->difficulty = (Difficulty) header.difficulty;
+	game->sync_frame_rate = header.sync_frame_rate;
+	game->width_dist = std::uniform_int_distribution<int>(0, game->width - 1);
+	game->height_dist = std::uniform_int_distribution<int>(0, game->height - 1);
+
+	std::istringstream rng(std::string(data + sizeof(header), header.rng_length));
+	rng >> game->random_engine;
+	if (rng.fail()) {
+		delete game;
+		return nullptr;
+	}
+
+	// copy the body in whole, which fails if a cell repeats
+	Snake* snake = new Snake();
+	game->snake = snake;
+	if (level != nullptr) {
+		game->set_level(level);
+	}
+	if (!snake->assign(cells, header.segment_count)) {
+		delete game;
+		return nullptr;
+	}
+	snake->direction = (Direction) header.direction;
+	snake->pause = header.pause;
+
+	// the treasure must lie on a free cell, unless the Snake has
+	// already filled the board and no treasure remains
+	game->treasure = Point(header.treasure_x, header.treasure_y);
+	long long max_length = (long long) game->width * game->height;
+	if (level != nullptr) {
+		max_length = level->open_cells;
+	}
+	if (header.segment_count != max_length
+	        && game->is_blocked(header.treasure_x, header.treasure_y)) {
+		delete game;
+		return nullptr;
+	}
+	*error = "";
+	return game;
+}
+
+/**
+ * Create an independent copy of a Game, e.g. for a bot to explore
+ * a branch of play without disturbing the original.
+ * @param game The Game to copy.
+ * @return A new Game with identical state.
+ */
+Game* clone_game(Game* game) {
+	Game* clone = new Game();
+	clone->width = game->width;
+	clone->height = game->height;
+	clone->difficulty = game->difficulty;
+	clone->sync_frame_rate = game->sync_frame_rate;
+	clone->snake = new Snake(*game->snake);
+	clone->treasure = game->treasure;
+	clone->quit = game->quit;
+	if (game->level != nullptr) {
+		// a fresh mapping of the level, marked with the body alone
+		clone->set_level(game->level);
+		for (int i = 0; i < clone->snake->segment_count; i++) {
+			clone->snake->mark(clone->snake->segment(i));
+		}
+	}
+	clone->vacated = game->vacated;
+	clone->random_engine = game->random_engine;
+	clone->width_dist = game->width_dist;
+	clone->height_dist = game->height_dist;
+	return clone;
+}
+
+/**
+ * Write a snapshot of the Game to a file.
+ * @param game The Game to save.
+ * @param path The file to write to.
+ * @return true if the snapshot was written, else false.
+ */
+bool save_snapshot(Game* game, const std::string& path) {
+	std::string data = encode_snapshot(game);
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	bool ok = write(fd, data.data(), data.length()) == (ssize_t) data.length();
+	ok = close(fd) == 0 && ok;
+	return ok;
+}
+
+/**
+ * Restore a Game from a snapshot file using a single read.
+ * @param path The file to read from.
+ * @param level The Level to play on, which must be the one the game was
+ *        saved on, or nullptr if it was saved without a Level.
+ * @param error Set to a description of the problem if loading fails.
+ * @return The restored Game, or nullptr if it could not be loaded.
+ */
+Game* load_snapshot(const std::string& path, Level* level, std::string* error) {
+	*error = "The file could not be read.";
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return nullptr;
+	}
+	std::string data(st.st_size, '\0');
+	bool ok = read(fd, &data[0], data.length()) == (ssize_t) data.length();
+	close(fd);
+	if (!ok) {
+		return nullptr;
+	}
+	return decode_snapshot(data.data(), data.length(), level, error);
+}
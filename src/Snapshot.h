@@ -0,0 +1,95 @@
+/*
+ * Snapshot.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: aaron
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdbool.h>
+#include "Game.h"
+
+/**
+ * Identifies a snapshot file, and the layout version it was written with.
+ */
+#define SNAPSHOT_MAGIC   0x534b4e53 // "SNKS"
+#define SNAPSHOT_VERSION 2
+
+/**
+ * Fixed-size header at the start of every snapshot.
+ *
+ * It is followed by rng_length bytes of RNG state (padded to a multiple
+ * of 4), then by segment_count (x, y) pairs of int32_t ordered from the
+ * Snake's head to its tail, the same layout as Snake::body, so the body
+ * is restored with a single memcpy. All fields are in native byte order.
+ *
+ * A game played on a Level records the Level's identity: the board size
+ * is the Level's size, and level_checksum is the Level's checksum.
+ */
+struct SnapshotHeader {
+	uint32_t magic;
+	uint32_t version;
+	int32_t width;
+	int32_t height;
+	uint8_t difficulty;
+	uint8_t sync_frame_rate;
+	uint8_t direction;
+	uint8_t pause;
+	int32_t treasure_x;
+	int32_t treasure_y;
+	uint32_t rng_length;
+	int32_t segment_count;
+	uint32_t has_level;
+	uint64_t level_checksum;
+};
+
+/**
+ * Serialize the complete state of a Game.
+ * @param game The Game to serialize.
+ * @return The snapshot bytes.
+ */
+std::string encode_snapshot(Game* game);
+
+/**
+ * Rebuild a Game from snapshot bytes.
+ * @param data The snapshot bytes.
+ * @param size The number of bytes available at data.
+ * @param level The Level to play on, which must be the one the game was
+ *        saved on, or nullptr if it was saved without a Level.
+ * @param error Set to a description of the problem if decoding fails.
+ * @return The restored Game, or nullptr if the data is not a valid snapshot.
+ */
+Game* decode_snapshot(const char* data, size_t size, Level* level, std::string* error);
+
+/**
+ * Create an independent copy of a Game, e.g. for a bot to explore
+ * a branch of play without disturbing the original.
+ * @param game The Game to copy.
+ * @return A new Game with identical state.
+ */
+Game* clone_game(Game* game);
+
+/**
+ * Write a snapshot of the Game to a file.
+ * @param game The Game to save.
+ * @param path The file to write to.
+ * @return true if the snapshot was written, else false.
+ */
+bool save_snapshot(Game* game, const std::string& path);
+
+/**
+ * Restore a Game from a snapshot file using a single read.
+ * @param path The file to read from.
+ * @param level The Level to play on, which must be the one the game was
+ *        saved on, or nullptr if it was saved without a Level.
+ * @param error Set to a description of the problem if loading fails.
+ * @return The restored Game, or nullptr if it could not be loaded.
+ */
+Game* load_snapshot(const std::string& path, Level* level, std::string* error);
+
+#endif /* SNAPSHOT_H_ */
@@ -0,0 +1,52 @@
+//============================================================================
+// Name        : LevelCompiler.cpp
+// Description : Compiles a text level into the binary format loaded by
+//               SnakeGame --level, precomputing its distance field.
+//============================================================================
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Level.h"
+
+/**
+ * Run the compiler.
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return zero on success, one on failure.
+ */
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cout << "Usage: LevelCompiler level.txt level.lvl" << std::endl;
+		std::cout << std::endl;
+		std::cout << "In the text level, '#' is a wall, 'S' is the snake's starting cell, and "
+		          << "anything else is open." << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in) {
+		std::cout << "Unable to read \"" << argv[1] << "\"." << std::endl;
+		return 1;
+	}
+	std::stringstream text;
+	text << in.rdbuf();
+
+	std::string error;
+	std::string data = compile_level(text.str(), &error);
+	if (data.empty()) {
+		std::cout << error << std::endl;
+		return 1;
+	}
+
+	std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+	out.write(data.data(), data.length());
+	out.close();
+	if (!out) {
+		std::cout << "Unable to write \"" << argv[2] << "\"." << std::endl;
+		return 1;
+	}
+	return 0;
+}